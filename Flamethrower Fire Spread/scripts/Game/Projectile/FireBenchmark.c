@@ -0,0 +1,283 @@
+// FireBenchmark.c
+//
+// Reproducible load test for the fire systems.
+// Attach to any entity in a test world (an empty terrain run on a dedicated/headless server is the
+// intended setup). After the start delay it seeds the RNG, fixes the wind and mutes spawner debug
+// output, then spawns the listed impacts of the spawner prefab at their offsets and times.
+// Every report interval it prints the time spent in the fire ticks (simulation, its grid step and the
+// visuals, in milliseconds per second of run), fire cell counts, entity spawns and traces per second
+// and the number of fire CallLater entries in the queue; a summary follows at the end.
+// Compare the summaries of two builds to see what a change to the fire code costs. The frame interval
+// is printed too, but a server capped at a fixed FPS shows the cap there, not the fire cost.
+//
+// No benchmark world ships with the mod — place this component in your own test world.
+// Other scripts drawing from the same RNG can still shift the spread — keep the world empty.
+
+[BaseContainerProps()]
+class FireBenchmarkImpact
+{
+	[Attribute("0 0 0", UIWidgets.Coords, "Impact position relative to the benchmark entity.")]
+	vector m_vOffset;
+
+	[Attribute("0 1 0", UIWidgets.Coords, "Surface normal at the impact. 0 1 0 = flat ground.")]
+	vector m_vNormal;
+
+	[Attribute("0", UIWidgets.EditBox, "Impact direction (yaw, degrees).")]
+	float m_fYaw;
+
+	[Attribute("0", UIWidgets.EditBox, "Seconds after the run starts. List impacts in firing order.")]
+	float m_fDelay;
+}
+
+[ComponentEditorProps(category: "WW2Vehicles/Projectile", description: "Fire benchmark: fires a scripted set of impacts with a fixed seed and wind and reports fire cost.")]
+class FireBenchmarkClass : ScriptComponentClass {}
+
+class FireBenchmark : ScriptComponent
+{
+	[Attribute("", UIWidgets.ResourcePickerThumbnail, "Prefab with a FireSpreadSpawner, spawned at each impact.", params: "et")]
+	protected ResourceName m_rSpawnerPrefab;
+
+	[Attribute()]
+	protected ref array<ref FireBenchmarkImpact> m_aImpacts;
+
+	[Attribute("1337", UIWidgets.EditBox, "RNG seed set at the start of the run.")]
+	protected int m_iSeed;
+
+	[Attribute("1 0 0", UIWidgets.Coords, "Fixed downwind direction used by every spawner during the run, instead of the weather.")]
+	protected vector m_vWind;
+
+	[Attribute("5", UIWidgets.EditBox, "Seconds after world start before the run begins, so loading doesn't count.")]
+	protected float m_fStartDelay;
+
+	[Attribute("60", UIWidgets.EditBox, "Length of the run (seconds).")]
+	protected float m_fDuration;
+
+	[Attribute("5", UIWidgets.EditBox, "Seconds between progress reports.")]
+	protected float m_fReportInterval;
+
+	[Attribute("0", UIWidgets.CheckBox, "Close the game when the run is done — for unattended headless runs.")]
+	protected bool m_bQuitWhenDone;
+
+	protected bool  m_bRunning;
+	protected float m_fElapsed;
+	protected float m_fNextReport;
+	protected int   m_iNextImpact;
+
+	// Current report window
+	protected int   m_iFrames;
+	protected float m_fFrameSum;		// seconds between frames — includes any FPS cap idle time
+	protected float m_fFrameMax;
+	protected int   m_iTracesAtWindow;
+	protected int   m_iSpawnsAtWindow;
+	protected int   m_iSimulationMsAtWindow;
+	protected int   m_iGridMsAtWindow;
+	protected int   m_iVisualMsAtWindow;
+	protected float m_fWindowStart;
+
+	// Whole run
+	protected int   m_iTotalFrames;
+	protected float m_fTotalFrameSum;
+	protected float m_fTotalFrameMax;
+	protected int   m_iPeakCells;
+	protected int   m_iPeakScheduled;
+
+	//------------------------------------------------------------------------------------------------
+	override protected void OnPostInit(IEntity owner)
+	{
+		super.OnPostInit(owner);
+
+		// Fire is simulated on the server only, so that's where the benchmark runs.
+		RplComponent rpl = RplComponent.Cast(owner.FindComponent(RplComponent));
+		if (rpl && rpl.IsProxy())
+			return;
+
+		SetEventMask(owner, EntityEvent.FRAME);
+		GetGame().GetCallqueue().CallLater(StartRun, m_fStartDelay * 1000, false);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void StartRun()
+	{
+		if (m_rSpawnerPrefab.IsEmpty() || !m_aImpacts || m_aImpacts.IsEmpty())
+		{
+			Print("[FireBenchmark] No spawner prefab or impacts set — nothing to run.", LogLevel.ERROR);
+			return;
+		}
+
+		Math.Randomize(m_iSeed);
+		FireSpreadSpawner.SetBenchmarkMode(true, m_vWind);
+		FireStats.Reset();
+
+		m_bRunning       = true;
+		m_fElapsed       = 0;
+		m_fNextReport    = m_fReportInterval;
+		m_iNextImpact    = 0;
+		m_iTotalFrames   = 0;
+		m_fTotalFrameSum = 0;
+		m_fTotalFrameMax = 0;
+		m_iPeakCells     = 0;
+		m_iPeakScheduled = 0;
+		ResetWindow();
+
+		Print("[FireBenchmark] Run started: " + m_aImpacts.Count() + " impacts, seed " + m_iSeed + ", wind " + m_vWind + ", " + m_fDuration + " s.", LogLevel.NORMAL);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	override protected void EOnFrame(IEntity owner, float timeSlice)
+	{
+		if (!m_bRunning)
+			return;
+
+		m_fElapsed += timeSlice;
+
+		m_iFrames++;
+		m_fFrameSum += timeSlice;
+		if (timeSlice > m_fFrameMax)
+			m_fFrameMax = timeSlice;
+
+		m_iPeakCells = Math.Max(m_iPeakCells, FireSimulationManager.GetInstance().GetCellCount());
+		m_iPeakScheduled = Math.Max(m_iPeakScheduled, FireStats.s_iScheduled);
+
+		while (m_iNextImpact < m_aImpacts.Count() && m_aImpacts[m_iNextImpact].m_fDelay <= m_fElapsed)
+		{
+			SpawnImpact(owner, m_aImpacts[m_iNextImpact]);
+			m_iNextImpact++;
+		}
+
+		if (m_fElapsed >= m_fNextReport)
+		{
+			Report();
+			m_fNextReport += m_fReportInterval;
+		}
+
+		if (m_fElapsed >= m_fDuration)
+			FinishRun();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void SpawnImpact(IEntity owner, FireBenchmarkImpact impact)
+	{
+		Resource res = Resource.Load(m_rSpawnerPrefab);
+		if (!res || !res.IsValid())
+		{
+			Print("[FireBenchmark] Failed to load spawner prefab: " + m_rSpawnerPrefab, LogLevel.ERROR);
+			m_bRunning = false;
+			return;
+		}
+
+		// +Y of the spawner is the surface normal, +Z the impact direction — as the warhead sets it.
+		vector up = impact.m_vNormal.Normalized();
+		if (up.LengthSq() < 0.01)
+			up = vector.Up;
+
+		vector dir = vector.FromYaw(impact.m_fYaw);
+		vector right = Vector(up[1]*dir[2] - up[2]*dir[1], up[2]*dir[0] - up[0]*dir[2], up[0]*dir[1] - up[1]*dir[0]);
+		if (right.LengthSq() < 0.0001)
+			right = Vector(1, 0, 0);
+		right.Normalize();
+		vector fwd = Vector(right[1]*up[2] - right[2]*up[1], right[2]*up[0] - right[0]*up[2], right[0]*up[1] - right[1]*up[0]);
+
+		EntitySpawnParams params = new EntitySpawnParams();
+		params.TransformMode = ETransformMode.WORLD;
+		params.Transform[0] = right;
+		params.Transform[1] = up;
+		params.Transform[2] = fwd;
+		params.Transform[3] = owner.GetOrigin() + impact.m_vOffset;
+
+		GetGame().SpawnEntityPrefab(res, owner.GetWorld(), params);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void Report()
+	{
+		float window = Math.Max(m_fElapsed - m_fWindowStart, 0.001);
+		float avgMs = 0;
+		if (m_iFrames > 0)
+			avgMs = m_fFrameSum / m_iFrames * 1000;
+
+		float maxMs = m_fFrameMax * 1000;
+		float spawns = FireStats.s_iEntitySpawns - m_iSpawnsAtWindow;
+		float traces = FireStats.s_iTraces - m_iTracesAtWindow;
+		float spawnRate = spawns / window;
+		float traceRate = traces / window;
+		float simMs = FireStats.s_iSimulationMs - m_iSimulationMsAtWindow;
+		float gridMs = FireStats.s_iGridMs - m_iGridMsAtWindow;
+		float visualMs = FireStats.s_iVisualMs - m_iVisualMsAtWindow;
+		float simRate = simMs / window;
+		float gridRate = gridMs / window;
+		float visualRate = visualMs / window;
+
+		FireSpreadGrid grid = FireSimulationManager.GetInstance().GetGrid();
+		Print("[FireBenchmark] t=" + m_fElapsed.ToString(-1, 1) + "s"
+			+ " | fire ms/s: simulation " + simRate.ToString(-1, 2) + " (grid " + gridRate.ToString(-1, 2) + "), visuals " + visualRate.ToString(-1, 2)
+			+ " | frame interval avg " + avgMs.ToString(-1, 2) + " ms, max " + maxMs.ToString(-1, 2) + " ms"
+			+ " | cells " + FireSimulationManager.GetInstance().GetCellCount()
+			+ ", grid " + grid.GetCellCount() + " (front " + grid.GetFrontierCount() + ")"
+			+ ", visuals " + FireVisualManager.GetInstance().GetCellCount() + " in " + FireVisualManager.GetInstance().GetClusterCount() + " clusters"
+			+ " | spawns/s " + spawnRate.ToString(-1, 1)
+			+ ", traces/s " + traceRate.ToString(-1, 1)
+			+ " | scheduled " + FireStats.s_iScheduled
+			+ ", trees queued " + FireVegetationQueue.GetInstance().GetQueuedCount(), LogLevel.NORMAL);
+
+		m_iTotalFrames   += m_iFrames;
+		m_fTotalFrameSum += m_fFrameSum;
+		m_fTotalFrameMax = Math.Max(m_fTotalFrameMax, m_fFrameMax);
+		ResetWindow();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void FinishRun()
+	{
+		Report();
+		m_bRunning = false;
+		FireSpreadSpawner.SetBenchmarkMode(false, vector.Zero);
+
+		float avgMs = 0;
+		if (m_iTotalFrames > 0)
+			avgMs = m_fTotalFrameSum / m_iTotalFrames * 1000;
+
+		float runTime = Math.Max(m_fElapsed, 0.001);
+		float maxMs = m_fTotalFrameMax * 1000;
+		float totalSpawns = FireStats.s_iEntitySpawns;
+		float totalTraces = FireStats.s_iTraces;
+		float spawnRate = totalSpawns / runTime;
+		float traceRate = totalTraces / runTime;
+		float totalSimMs = FireStats.s_iSimulationMs;
+		float simRate = totalSimMs / runTime;
+
+		Print("[FireBenchmark] Summary: " + m_iTotalFrames + " frames"
+			+ " | fire ms: simulation " + FireStats.s_iSimulationMs + " (" + simRate.ToString(-1, 2) + "/s)"
+			+ ", grid " + FireStats.s_iGridMs + ", visuals " + FireStats.s_iVisualMs
+			+ " | frame interval avg " + avgMs.ToString(-1, 2) + " ms, max " + maxMs.ToString(-1, 2) + " ms"
+			+ " | peak cells " + m_iPeakCells
+			+ " | spawns " + FireStats.s_iEntitySpawns + " (" + spawnRate.ToString(-1, 1) + "/s)"
+			+ ", traces " + FireStats.s_iTraces + " (" + traceRate.ToString(-1, 1) + "/s)"
+			+ " | peak scheduled " + m_iPeakScheduled
+			+ ", budget evictions " + FireBudget.GetInstance().GetEvictedCount(), LogLevel.NORMAL);
+
+		if (m_bQuitWhenDone)
+			GetGame().RequestClose();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void ResetWindow()
+	{
+		m_iFrames         = 0;
+		m_fFrameSum       = 0;
+		m_fFrameMax       = 0;
+		m_iTracesAtWindow = FireStats.s_iTraces;
+		m_iSpawnsAtWindow = FireStats.s_iEntitySpawns;
+		m_iSimulationMsAtWindow = FireStats.s_iSimulationMs;
+		m_iGridMsAtWindow       = FireStats.s_iGridMs;
+		m_iVisualMsAtWindow     = FireStats.s_iVisualMs;
+		m_fWindowStart    = m_fElapsed;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	override protected void OnDelete(IEntity owner)
+	{
+		GetGame().GetCallqueue().Remove(StartRun);
+		if (m_bRunning)
+			FireSpreadSpawner.SetBenchmarkMode(false, vector.Zero);
+	}
+}
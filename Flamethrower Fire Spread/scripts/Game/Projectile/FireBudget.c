@@ -0,0 +1,242 @@
+// FireBudget.c
+//
+// Server-wide cap on burning fire cells, shared by every FireSpreadSpawner.
+// Per-impact caps (m_iMaxAlive, m_iHardCap, the material cap) still apply; this budget limits the
+// sum of all impacts. Every spawner registers here and asks for an allowance before placing a node,
+// and unregisters once its impact has burnt out.
+// Spawner prefabs may ask for different budgets; the tightest one wins, whichever impact came last.
+// While the budget has room every request is granted. Once it is full, a request only succeeds by
+// evicting the lowest-priority burning cell in the whole pool, and only if the new node outranks it.
+//
+// Priority of a cell:
+//   + its impact's closeness to the nearest player (refreshed every PRIORITY_REFRESH seconds)
+//   − its impact's share of the budget (impacts with many nodes give way first)
+//   − its age relative to its lifetime (cells about to burn out anyway go first)
+//
+// Server only.
+
+class FireBudget
+{
+	protected static ref FireBudget s_Instance;
+
+	protected static const float PRIORITY_REFRESH = 1.0;		// seconds between player distance updates
+	protected static const float PRIORITY_RANGE   = 500.0;	// metres — beyond this an impact gets no closeness bonus
+	protected static const float DISTANCE_WEIGHT  = 1.0;
+	protected static const float SHARE_WEIGHT     = 0.5;
+	protected static const float AGE_WEIGHT       = 0.5;
+	protected static const float EVICT_MARGIN     = 0.05;	// a new node must beat the victim by this much — stops evict/refill churn
+	protected static const float ORPHAN_PRIORITY  = -1.0;	// cells whose spawner is gone
+
+	// Registered impacts — struct of arrays, all index-aligned. Removal moves the last one into the hole.
+	protected ref array<int>    m_aSpawnerId  = new array<int>();
+	protected ref array<vector> m_aOrigin     = new array<vector>();
+	protected ref array<float>  m_aCloseness  = new array<float>();	// 0..1, 1 = a player stands on the impact
+	protected ref map<int, int> m_mIndex      = new map<int, int>();	// spawner id -> index
+
+	protected ref array<vector> m_aPlayerPos = new array<vector>();	// reused by RefreshPriorities
+	protected ref array<int>    m_aPlayerIds = new array<int>();
+
+	protected int  m_iBudget = 150;
+	protected bool m_bBudgetConfigured;	// a spawner has set the budget — later ones can only tighten it
+	protected int  m_iEvicted;
+	protected bool m_bRefreshing;
+
+	//------------------------------------------------------------------------------------------------
+	static FireBudget GetInstance()
+	{
+		if (!s_Instance)
+			s_Instance = new FireBudget();
+		return s_Instance;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// 0 = no server-wide limit. The first call replaces the default; later calls only take effect
+	// when they are tighter, so spawners with different settings don't overwrite each other.
+	void SetBudget(int budget)
+	{
+		budget = Math.Max(budget, 0);
+		if (m_bBudgetConfigured && (budget == 0 || (m_iBudget > 0 && budget >= m_iBudget)))
+			return;
+
+		m_bBudgetConfigured = true;
+		m_iBudget = budget;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	int GetBudget()
+	{
+		return m_iBudget;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// Cells evicted to make room for higher-priority nodes since the session started.
+	int GetEvictedCount()
+	{
+		return m_iEvicted;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	void RegisterSpawner(int spawnerId, vector origin)
+	{
+		if (m_mIndex.Contains(spawnerId))
+			return;
+
+		int index = m_aSpawnerId.Insert(spawnerId);
+		m_aOrigin.Insert(origin);
+		m_aCloseness.Insert(ComputeCloseness(origin, CollectPlayerPositions()));
+		m_mIndex.Insert(spawnerId, index);
+
+		if (!m_bRefreshing)
+		{
+			m_bRefreshing = true;
+			FireStats.s_iScheduled++;
+			GetGame().GetCallqueue().CallLater(RefreshPriorities, PRIORITY_REFRESH * 1000, true);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// Cells of an unregistered spawner drop to the lowest priority and are evicted first.
+	void UnregisterSpawner(int spawnerId)
+	{
+		int index;
+		if (!m_mIndex.Find(spawnerId, index))
+			return;
+
+		int last = m_aSpawnerId.Count() - 1;
+		m_mIndex.Remove(spawnerId);
+
+		if (index != last)
+		{
+			m_aSpawnerId[index] = m_aSpawnerId[last];
+			m_aOrigin[index]    = m_aOrigin[last];
+			m_aCloseness[index] = m_aCloseness[last];
+			m_mIndex.Set(m_aSpawnerId[index], index);
+		}
+
+		m_aSpawnerId.Remove(last);
+		m_aOrigin.Remove(last);
+		m_aCloseness.Remove(last);
+
+		if (m_aSpawnerId.IsEmpty() && m_bRefreshing)
+		{
+			m_bRefreshing = false;
+			FireStats.s_iScheduled--;
+			GetGame().GetCallqueue().Remove(RefreshPriorities);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// Asks for room for one more node of this spawner. May evict a lower-priority cell of any spawner.
+	bool RequestAllowance(int spawnerId)
+	{
+		if (m_iBudget <= 0)
+			return true;
+
+		FireSimulationManager manager = FireSimulationManager.GetInstance();
+		if (manager.GetCellCount() < m_iBudget)
+			return true;
+
+		float victimPriority;
+		int victim = manager.FindLowestPriorityCell(victimPriority);
+		if (victim == 0)
+			return false;
+
+		// The new node would start at age 0.
+		if (GetSpawnerPriority(spawnerId) < victimPriority + EVICT_MARGIN)
+			return false;
+
+		if (!manager.EvictCell(victim))
+			return false;
+
+		m_iEvicted++;
+		return true;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// Evicts the lowest-priority cells until the pool fits the budget again (after the budget was lowered).
+	void Enforce()
+	{
+		if (m_iBudget <= 0)
+			return;
+
+		FireSimulationManager manager = FireSimulationManager.GetInstance();
+		while (manager.GetCellCount() > m_iBudget)
+		{
+			float victimPriority;
+			int victim = manager.FindLowestPriorityCell(victimPriority);
+			if (victim == 0 || !manager.EvictCell(victim))
+				return;
+
+			m_iEvicted++;
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// Priority of a cell of this spawner that has burnt for ageFraction (0..1) of its lifetime.
+	float GetCellPriority(int spawnerId, float ageFraction)
+	{
+		return GetSpawnerPriority(spawnerId) - AGE_WEIGHT * ageFraction;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected float GetSpawnerPriority(int spawnerId)
+	{
+		int index;
+		if (!m_mIndex.Find(spawnerId, index))
+			return ORPHAN_PRIORITY;
+
+		float share = 0;
+		FireSpreadSpawner spawner = FireSimulationManager.GetInstance().GetSpawner(spawnerId);
+		if (spawner && m_iBudget > 0)
+		{
+			float alive = spawner.GetAliveCount();
+			share = alive / m_iBudget;
+		}
+
+		return DISTANCE_WEIGHT * m_aCloseness[index] - SHARE_WEIGHT * share;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void RefreshPriorities()
+	{
+		array<vector> players = CollectPlayerPositions();
+		for (int i = m_aSpawnerId.Count() - 1; i >= 0; i--)
+		{
+			m_aCloseness[i] = ComputeCloseness(m_aOrigin[i], players);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected array<vector> CollectPlayerPositions()
+	{
+		m_aPlayerPos.Clear();
+
+		PlayerManager playerManager = GetGame().GetPlayerManager();
+		if (!playerManager)
+			return m_aPlayerPos;
+
+		playerManager.GetPlayers(m_aPlayerIds);
+		foreach (int playerId : m_aPlayerIds)
+		{
+			IEntity controlled = playerManager.GetPlayerControlledEntity(playerId);
+			if (controlled)
+				m_aPlayerPos.Insert(controlled.GetOrigin());
+		}
+		return m_aPlayerPos;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// 1 at the nearest player, falling to 0 at PRIORITY_RANGE. 0 when nobody is playing.
+	protected float ComputeCloseness(vector origin, array<vector> players)
+	{
+		float nearestSq = PRIORITY_RANGE * PRIORITY_RANGE;
+		foreach (vector playerPos : players)
+		{
+			float distSq = vector.DistanceSq(origin, playerPos);
+			if (distSq < nearestSq)
+				nearestSq = distSq;
+		}
+
+		return 1.0 - Math.Sqrt(nearestSq) / PRIORITY_RANGE;
+	}
+}
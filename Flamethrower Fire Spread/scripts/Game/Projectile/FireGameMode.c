@@ -0,0 +1,24 @@
+// FireGameMode.c
+//
+// Replication channel for fire events that have no spawner to send them.
+// FireSimulationManager is not an entity, and a cell evicted by FireBudget may belong to a spawner
+// that was deleted, so those extinguishes go through the game mode, which every client always has.
+//
+// Server sends, every client receives.
+
+modded class SCR_BaseGameMode
+{
+	//------------------------------------------------------------------------------------------------
+	// Server: tells every client to stop drawing a cell. The caller removes it locally.
+	void BroadcastFireCellExtinguished(int cellId)
+	{
+		Rpc(RpcDo_FireCellExtinguished, cellId);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	[RplRpc(RplChannel.Reliable, RplRcver.Broadcast)]
+	protected void RpcDo_FireCellExtinguished(int cellId)
+	{
+		FireVisualManager.GetInstance().RemoveCell(cellId);
+	}
+}
@@ -0,0 +1,76 @@
+// FireQueue.c
+//
+// FIFO of (item, value) pairs for the fire systems that work through a backlog oldest first
+// (FireVegetationQueue's trees, FireSpreadGrid's cells to forget).
+// Popping only moves a head index forward. Once the spent entries in front of it outnumber the
+// live ones, the live tail is slid down over them and the arrays are resized in place.
+
+class FireQueue<Class TItem, Class TValue>
+{
+	protected ref array<TItem>  m_aItems  = new array<TItem>();
+	protected ref array<TValue> m_aValues = new array<TValue>();
+	protected int               m_iHead;
+
+	//------------------------------------------------------------------------------------------------
+	int Count()
+	{
+		return m_aItems.Count() - m_iHead;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	bool IsEmpty()
+	{
+		return m_iHead >= m_aItems.Count();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	void Push(TItem item, TValue value)
+	{
+		m_aItems.Insert(item);
+		m_aValues.Insert(value);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// Value of the oldest entry. The queue must not be empty.
+	TValue PeekValue()
+	{
+		return m_aValues[m_iHead];
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// Removes the oldest entry and returns its item. Read its value with PeekValue first if needed.
+	TItem Pop()
+	{
+		TItem item = m_aItems[m_iHead];
+		m_iHead++;
+
+		if (m_iHead * 2 > m_aItems.Count())
+			Compact();
+
+		return item;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	void Clear()
+	{
+		m_aItems.Clear();
+		m_aValues.Clear();
+		m_iHead = 0;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// Each entry is moved at most once per doubling of the backlog, so popping stays amortised O(1).
+	protected void Compact()
+	{
+		int live = m_aItems.Count() - m_iHead;
+		for (int i = 0; i < live; i++)
+		{
+			m_aItems[i] = m_aItems[m_iHead + i];
+			m_aValues[i] = m_aValues[m_iHead + i];
+		}
+
+		m_aItems.Resize(live);
+		m_aValues.Resize(live);
+		m_iHead = 0;
+	}
+}
@@ -0,0 +1,609 @@
+// FireSimulationManager.c
+//
+// Server-side simulation of every burning fire cell.
+// FireSpreadSpawner ignites cells here instead of spawning one replicated node entity per fire.
+// All cells live in one flat struct-of-arrays pool and are advanced together by a single
+// fixed-rate tick (ageing, intensity, damage, burn-out), so many impacts add pool rows,
+// not ticking entities and CallLater entries.
+// Damage spawns no entities: each tick the cells due a damage interval are gathered, one world query
+// over their bounds finds the characters near them, and those take EDamageType.FIRE directly. A cell's
+// hit grows with the intervals it has burnt, as the damage prefabs it once stacked up did.
+//
+// Multiplayer:
+//   • Only the server ignites and ticks cells.
+//   • Clients learn about cells from the owning spawner's broadcast and draw them with FireVisualManager.
+//   • Clients that join late or stream a spawner in get its burning cells from the spawner's snapshot.
+//   • Budget evictions are broadcast here through the game mode — the cell's spawner may be gone.
+
+//------------------------------------------------------------------------------------------------
+// Settings of one fire node prefab, read once from its FireSpreadNode component.
+class FireCellTemplate
+{
+	ResourceName m_rPrefab;
+	ResourceName m_rParticleEffect;
+	ResourceName m_rDecalPrefab;
+	float m_fDamageInterval = 0.5;
+	float m_fFireDamage = 5.0;
+	float m_fDamageRadius = 1.0;
+	float m_fTotalDuration = 8.0;
+	float m_fParticleLoopInterval = 2.0;
+	float m_fVisibleDistance = 250.0;
+	float m_fNearDistance = 60.0;
+	float m_fClusterSize = 8.0;
+	ResourceName m_rClusterParticle;
+	ResourceName m_rFarLightPrefab;
+	float m_fLightDistance = 800.0;
+	int   m_iIndex;					// position in s_aTemplates — cells store this instead of a reference
+
+	ref Resource m_DecalRes;		// loaded on first use
+	ref Resource m_FarLightRes;		// loaded on first use, clients only
+
+	protected static ref array<ref FireCellTemplate> s_aTemplates = new array<ref FireCellTemplate>();
+	protected static ref map<ResourceName, int> s_mTemplateIndex = new map<ResourceName, int>();
+
+	//------------------------------------------------------------------------------------------------
+	// Template for a node prefab, loaded on first request. Null if the prefab has no FireSpreadNode.
+	static FireCellTemplate Get(ResourceName prefab)
+	{
+		int index;
+		if (s_mTemplateIndex.Find(prefab, index))
+		{
+			if (index < 0)
+				return null;
+			return s_aTemplates[index];
+		}
+
+		FireCellTemplate tmpl = Load(prefab);
+		if (!tmpl)
+		{
+			// Remember the failure so the error is printed once, not per impact.
+			s_mTemplateIndex.Insert(prefab, -1);
+			return null;
+		}
+
+		tmpl.m_iIndex = s_aTemplates.Insert(tmpl);
+		s_mTemplateIndex.Insert(prefab, tmpl.m_iIndex);
+		return tmpl;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	static FireCellTemplate GetByIndex(int index)
+	{
+		if (index < 0 || index >= s_aTemplates.Count())
+			return null;
+		return s_aTemplates[index];
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected static FireCellTemplate Load(ResourceName prefab)
+	{
+		Resource res = Resource.Load(prefab);
+		if (!res || !res.IsValid())
+		{
+			Print("[FireCellTemplate] Failed to load node prefab: " + prefab, LogLevel.ERROR);
+			return null;
+		}
+
+		IEntitySource src = res.GetResource().ToEntitySource();
+		if (!src)
+			return null;
+
+		int count = src.GetComponentCount();
+		for (int i = 0; i < count; i++)
+		{
+			IEntityComponentSource comp = src.GetComponent(i);
+			if (!comp)
+				continue;
+
+			typename compType = comp.GetClassName().ToType();
+			if (!compType || !compType.IsInherited(FireSpreadNode))
+				continue;
+
+			FireCellTemplate tmpl = new FireCellTemplate();
+			tmpl.m_rPrefab = prefab;
+			comp.Get("m_rParticleEffect", tmpl.m_rParticleEffect);
+			comp.Get("m_rDecalPrefab", tmpl.m_rDecalPrefab);
+			comp.Get("m_fDamageInterval", tmpl.m_fDamageInterval);
+			comp.Get("m_fFireDamage", tmpl.m_fFireDamage);
+			comp.Get("m_fDamageRadius", tmpl.m_fDamageRadius);
+			comp.Get("m_fTotalDuration", tmpl.m_fTotalDuration);
+			comp.Get("m_fParticleLoopInterval", tmpl.m_fParticleLoopInterval);
+			comp.Get("m_fVisibleDistance", tmpl.m_fVisibleDistance);
+			comp.Get("m_fNearDistance", tmpl.m_fNearDistance);
+			comp.Get("m_fClusterSize", tmpl.m_fClusterSize);
+			comp.Get("m_rClusterParticle", tmpl.m_rClusterParticle);
+			comp.Get("m_rFarLightPrefab", tmpl.m_rFarLightPrefab);
+			comp.Get("m_fLightDistance", tmpl.m_fLightDistance);
+
+			if (tmpl.m_rClusterParticle.IsEmpty())
+				tmpl.m_rClusterParticle = tmpl.m_rParticleEffect;
+			if (tmpl.m_fClusterSize < 1)
+				tmpl.m_fClusterSize = 1;
+			return tmpl;
+		}
+
+		Print("[FireCellTemplate] Node prefab has no FireSpreadNode component: " + prefab, LogLevel.ERROR);
+		return null;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	Resource GetDecalResource()
+	{
+		if (!m_DecalRes && !m_rDecalPrefab.IsEmpty())
+		{
+			m_DecalRes = LoadPrefab(m_rDecalPrefab);
+			if (!m_DecalRes)
+				m_rDecalPrefab = ResourceName.Empty;	// failed — don't retry on every ignition
+		}
+		return m_DecalRes;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	Resource GetFarLightResource()
+	{
+		if (!m_FarLightRes && !m_rFarLightPrefab.IsEmpty())
+		{
+			m_FarLightRes = LoadPrefab(m_rFarLightPrefab);
+			if (!m_FarLightRes)
+				m_rFarLightPrefab = ResourceName.Empty;	// failed — don't retry on every tick
+		}
+		return m_FarLightRes;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected static Resource LoadPrefab(ResourceName prefab)
+	{
+		Resource res = Resource.Load(prefab);
+		if (res && res.IsValid())
+			return res;
+
+		Print("[FireCellTemplate] Failed to load prefab: " + prefab, LogLevel.ERROR);
+		return null;
+	}
+}
+
+//------------------------------------------------------------------------------------------------
+class FireSimulationManager
+{
+	protected static ref FireSimulationManager s_Instance;
+
+	protected static const float TICK_INTERVAL = 0.1;		// seconds — every cell advances at this fixed rate
+	protected static const float RAMP_UP_TIME  = 0.5;		// seconds from ignition to full intensity
+	protected static const float FADE_OUT_TIME = 1.5;		// seconds of fading before burn-out
+
+	// Cell pool — struct of arrays, all index-aligned. Removal moves the last cell into the hole.
+	protected ref array<int>    m_aCellId         = new array<int>();
+	protected ref array<vector> m_aCellPos        = new array<vector>();
+	protected ref array<float>  m_aCellAge        = new array<float>();
+	protected ref array<float>  m_aCellIntensity  = new array<float>();
+	protected ref array<int>    m_aCellSpawner    = new array<int>();
+	protected ref array<int>    m_aCellSlot       = new array<int>();	// the cell's slot in its spawner's live-node list, -1 = none
+	protected ref array<int>    m_aCellTemplate   = new array<int>();
+	protected ref array<float>  m_aCellNextDamage = new array<float>();
+	protected ref map<int, int> m_mCellIndex      = new map<int, int>();	// cell id -> pool index
+	protected ref map<int, ref array<int>> m_mCellBuckets = new map<int, ref array<int>>();	// FireSpreadGrid key -> ids of the cells in it, chain cells included
+
+	// Cells due a damage interval this tick — filled by Tick, applied by ApplyDamage. Reused every tick.
+	protected ref array<vector> m_aDuePos    = new array<vector>();
+	protected ref array<float>  m_aDueDamage = new array<float>();
+	protected ref array<float>  m_aDueRadius = new array<float>();
+	protected ref array<ChimeraCharacter> m_aDamageTargets = new array<ChimeraCharacter>();
+
+	protected ref map<int, FireSpreadSpawner> m_mSpawners = new map<int, FireSpreadSpawner>();	// weak — spawners unregister once burnt out, or in OnDelete
+	protected int  m_iNextSpawnerId = 1;
+	protected int  m_iNextCellId    = 1;
+	protected bool m_bTicking;
+
+	protected ref FireSpreadGrid m_Grid = new FireSpreadGrid();	// shared fire front for grid-spread spawners
+	protected float m_fGridTimer;
+
+	//------------------------------------------------------------------------------------------------
+	static FireSimulationManager GetInstance()
+	{
+		if (!s_Instance)
+			s_Instance = new FireSimulationManager();
+		return s_Instance;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// Returns the id cells of this spawner are tagged with. Burn-outs are reported to OnNodeDied
+	// together with the slot the spawner passed to Ignite.
+	int RegisterSpawner(FireSpreadSpawner spawner)
+	{
+		int id = m_iNextSpawnerId;
+		m_iNextSpawnerId++;
+		m_mSpawners.Insert(id, spawner);
+		return id;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// Cells of an unregistered spawner keep burning; nobody is told when they go out.
+	void UnregisterSpawner(int spawnerId)
+	{
+		m_mSpawners.Remove(spawnerId);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	FireSpreadSpawner GetSpawner(int spawnerId)
+	{
+		return m_mSpawners.Get(spawnerId);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	FireSpreadGrid GetGrid()
+	{
+		return m_Grid;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	int GetCellCount()
+	{
+		return m_aCellId.Count();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// Adds a burning cell and returns its id (stable for the cell's whole life). The spawner's slot
+	// is stored with the cell and handed back on burn-out or eviction, so the spawner never searches.
+	int Ignite(notnull FireCellTemplate tmpl, vector pos, int spawnerId, int slot = -1)
+	{
+		int id = m_iNextCellId;
+		m_iNextCellId++;
+
+		int index = m_aCellId.Insert(id);
+		m_aCellPos.Insert(pos);
+		m_aCellAge.Insert(0);
+		m_aCellIntensity.Insert(0);
+		m_aCellSpawner.Insert(spawnerId);
+		m_aCellSlot.Insert(slot);
+		m_aCellTemplate.Insert(tmpl.m_iIndex);
+		m_aCellNextDamage.Insert(tmpl.m_fDamageInterval);	// first hit one interval after ignition, as before
+		m_mCellIndex.Insert(id, index);
+		AddToBucket(id, pos);
+
+		if (!m_bTicking)
+		{
+			m_bTicking = true;
+			FireStats.s_iScheduled++;
+			GetGame().GetCallqueue().CallLater(Tick, TICK_INTERVAL * 1000, true);
+		}
+
+		return id;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// Removes a cell early (e.g. evicted by a cap). The owning spawner is not notified — the caller is it.
+	bool Extinguish(int cellId)
+	{
+		int index;
+		if (!m_mCellIndex.Find(cellId, index))
+			return false;
+
+		RemoveCellAt(index);
+		return true;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// Removes a cell to make room under the global budget, tells every machine to stop drawing it and
+	// tells its spawner (if still around). Orphaned cells have no spawner to broadcast for them.
+	bool EvictCell(int cellId)
+	{
+		int index;
+		if (!m_mCellIndex.Find(cellId, index))
+			return false;
+
+		int spawnerId = m_aCellSpawner[index];
+		int slot      = m_aCellSlot[index];
+		RemoveCellAt(index);
+
+		FireVisualManager.GetInstance().RemoveCell(cellId);
+		SCR_BaseGameMode gameMode = SCR_BaseGameMode.Cast(GetGame().GetGameMode());
+		if (gameMode)
+			gameMode.BroadcastFireCellExtinguished(cellId);
+
+		FireSpreadSpawner spawner = m_mSpawners.Get(spawnerId);
+		if (spawner)
+			spawner.OnNodeEvicted(cellId, slot);
+
+		return true;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// Cell FireBudget would evict first, 0 if there are none. Linear — only called with a full budget.
+	int FindLowestPriorityCell(out float priority)
+	{
+		FireBudget budget = FireBudget.GetInstance();
+		int lowestId;
+		for (int i = m_aCellId.Count() - 1; i >= 0; i--)
+		{
+			float ageFraction = 1;
+			FireCellTemplate tmpl = FireCellTemplate.GetByIndex(m_aCellTemplate[i]);
+			if (tmpl && tmpl.m_fTotalDuration > 0)
+				ageFraction = m_aCellAge[i] / tmpl.m_fTotalDuration;
+
+			float cellPriority = budget.GetCellPriority(m_aCellSpawner[i], ageFraction);
+			if (lowestId == 0 || cellPriority < priority)
+			{
+				lowestId = m_aCellId[i];
+				priority = cellPriority;
+			}
+		}
+		return lowestId;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	bool IsBurning(int cellId)
+	{
+		return m_mCellIndex.Contains(cellId);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// Position and remaining lifetime (seconds) of a burning cell. False if it is not burning.
+	bool GetCellState(int cellId, out vector pos, out float remaining)
+	{
+		int index;
+		if (!m_mCellIndex.Find(cellId, index))
+			return false;
+
+		FireCellTemplate tmpl = FireCellTemplate.GetByIndex(m_aCellTemplate[index]);
+		if (!tmpl)
+			return false;
+
+		pos = m_aCellPos[index];
+		remaining = tmpl.m_fTotalDuration - m_aCellAge[index];
+		return remaining > 0;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// True if any burning cell lies within radius of pos. Only the grid keys the radius overlaps are looked at.
+	bool HasCellNear(vector pos, float radius)
+	{
+		float radiusSq = radius * radius;
+		int minX = Math.Floor((pos[0] - radius) / FireSpreadGrid.CELL_SIZE);
+		int maxX = Math.Floor((pos[0] + radius) / FireSpreadGrid.CELL_SIZE);
+		int minZ = Math.Floor((pos[2] - radius) / FireSpreadGrid.CELL_SIZE);
+		int maxZ = Math.Floor((pos[2] + radius) / FireSpreadGrid.CELL_SIZE);
+
+		for (int x = minX; x <= maxX; x++)
+		{
+			for (int z = minZ; z <= maxZ; z++)
+			{
+				array<int> bucket = m_mCellBuckets.Get(FireSpreadGrid.MakeKey(x, z));
+				if (!bucket)
+					continue;
+
+				foreach (int cellId : bucket)
+				{
+					if (vector.DistanceSq(m_aCellPos[m_mCellIndex.Get(cellId)], pos) <= radiusSq)
+						return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected int GetBucketKey(vector pos)
+	{
+		int x = Math.Floor(pos[0] / FireSpreadGrid.CELL_SIZE);
+		int z = Math.Floor(pos[2] / FireSpreadGrid.CELL_SIZE);
+		return FireSpreadGrid.MakeKey(x, z);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void AddToBucket(int cellId, vector pos)
+	{
+		int key = GetBucketKey(pos);
+		array<int> bucket = m_mCellBuckets.Get(key);
+		if (!bucket)
+		{
+			bucket = new array<int>();
+			m_mCellBuckets.Insert(key, bucket);
+		}
+		bucket.Insert(cellId);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void RemoveFromBucket(int cellId, vector pos)
+	{
+		int key = GetBucketKey(pos);
+		array<int> bucket = m_mCellBuckets.Get(key);
+		if (!bucket)
+			return;
+
+		bucket.RemoveItem(cellId);
+		if (bucket.IsEmpty())
+			m_mCellBuckets.Remove(key);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void Tick()
+	{
+		int tickStart = System.GetTickCount();
+		BaseWorld world = GetGame().GetWorld();
+
+		m_aDuePos.Clear();
+		m_aDueDamage.Clear();
+		m_aDueRadius.Clear();
+
+		// Backwards so moving the last cell into a removed slot never skips one.
+		for (int i = m_aCellId.Count() - 1; i >= 0; i--)
+		{
+			FireCellTemplate tmpl = FireCellTemplate.GetByIndex(m_aCellTemplate[i]);
+			float age = m_aCellAge[i] + TICK_INTERVAL;
+			if (!tmpl || age >= tmpl.m_fTotalDuration)
+			{
+				BurnOut(i);
+				continue;
+			}
+
+			m_aCellAge[i] = age;
+			m_aCellIntensity[i] = ComputeIntensity(age, tmpl.m_fTotalDuration);
+
+			if (age >= m_aCellNextDamage[i])
+			{
+				m_aCellNextDamage[i] = age + tmpl.m_fDamageInterval;
+				QueueDamage(i, tmpl, age);
+			}
+		}
+
+		if (!m_aDuePos.IsEmpty())
+			ApplyDamage(world);
+
+		// Only evicts when the budget was lowered below the pool size — a count compare otherwise.
+		FireBudget.GetInstance().Enforce();
+
+		// Grid spread runs at its own slower rate, after the pool update so burn-outs are already visible.
+		m_fGridTimer += TICK_INTERVAL;
+		if (m_fGridTimer >= FireSpreadGrid.STEP_INTERVAL)
+		{
+			m_fGridTimer -= FireSpreadGrid.STEP_INTERVAL;
+			int gridStart = System.GetTickCount();
+			m_Grid.Step(world);
+			FireStats.s_iGridMs += System.GetTickCount() - gridStart;
+		}
+
+		if (m_aCellId.IsEmpty())
+		{
+			m_bTicking = false;
+			FireStats.s_iScheduled--;
+			GetGame().GetCallqueue().Remove(Tick);
+		}
+
+		FireStats.s_iSimulationMs += System.GetTickCount() - tickStart;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// 0..1 — ramps up after ignition and fades before burn-out.
+	protected float ComputeIntensity(float age, float duration)
+	{
+		float rampUp  = Math.Clamp(age / RAMP_UP_TIME, 0, 1);
+		float fadeOut = Math.Clamp((duration - age) / FADE_OUT_TIME, 0, 1);
+		return Math.Min(rampUp, fadeOut);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// One damage interval passed. The hit is multiplied by the intervals burnt so far, so damage still
+	// builds up with the cell's age as it did when every interval left another damage prefab on it.
+	protected void QueueDamage(int index, FireCellTemplate tmpl, float age)
+	{
+		if (tmpl.m_fFireDamage <= 0 || tmpl.m_fDamageRadius <= 0)
+			return;
+
+		float intervals = 1;
+		if (tmpl.m_fDamageInterval > 0)
+			intervals = Math.Max(Math.Floor(age / tmpl.m_fDamageInterval), 1);
+
+		m_aDuePos.Insert(m_aCellPos[index]);
+		m_aDueDamage.Insert(tmpl.m_fFireDamage * intervals);
+		m_aDueRadius.Insert(tmpl.m_fDamageRadius);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// One query over the bounds of every cell due this tick, then each character found takes the
+	// hits of the due cells it stands in.
+	protected void ApplyDamage(BaseWorld world)
+	{
+		vector mins = m_aDuePos[0];
+		vector maxs = m_aDuePos[0];
+		float maxRadius;
+		for (int i = m_aDuePos.Count() - 1; i >= 0; i--)
+		{
+			vector pos = m_aDuePos[i];
+			for (int axis = 0; axis < 3; axis++)
+			{
+				mins[axis] = Math.Min(mins[axis], pos[axis]);
+				maxs[axis] = Math.Max(maxs[axis], pos[axis]);
+			}
+			maxRadius = Math.Max(maxRadius, m_aDueRadius[i]);
+		}
+
+		vector reach = Vector(maxRadius, maxRadius, maxRadius);
+		m_aDamageTargets.Clear();
+		world.QueryEntitiesByAABB(mins - reach, maxs + reach, CollectDamageTarget, null, EQueryEntitiesFlags.DYNAMIC);
+
+		foreach (ChimeraCharacter character : m_aDamageTargets)
+		{
+			vector charPos = character.GetOrigin();
+			float damage;
+			for (int due = m_aDuePos.Count() - 1; due >= 0; due--)
+			{
+				float radius = m_aDueRadius[due];
+				if (vector.DistanceSq(charPos, m_aDuePos[due]) <= radius * radius)
+					damage += m_aDueDamage[due];
+			}
+
+			if (damage > 0)
+				DamageCharacter(character, damage);
+		}
+		m_aDamageTargets.Clear();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected bool CollectDamageTarget(IEntity ent)
+	{
+		ChimeraCharacter character = ChimeraCharacter.Cast(ent);
+		if (character)
+			m_aDamageTargets.Insert(character);
+		return true;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void DamageCharacter(ChimeraCharacter character, float damage)
+	{
+		SCR_CharacterDamageManagerComponent damageManager = SCR_CharacterDamageManagerComponent.Cast(character.FindComponent(SCR_CharacterDamageManagerComponent));
+		if (!damageManager || damageManager.GetState() == EDamageState.DESTROYED)
+			return;
+
+		vector hitPosDirNorm[3];
+		hitPosDirNorm[0] = character.GetOrigin();
+		hitPosDirNorm[1] = vector.Up;
+		hitPosDirNorm[2] = vector.Up;
+
+		SCR_DamageContext context = new SCR_DamageContext(EDamageType.FIRE, damage, hitPosDirNorm, character,
+			damageManager.GetDefaultHitZone(), Instigator.CreateInstigator(null), null, -1, -1);
+		damageManager.HandleDamage(context);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void BurnOut(int index)
+	{
+		int cellId    = m_aCellId[index];
+		int spawnerId = m_aCellSpawner[index];
+		int slot      = m_aCellSlot[index];
+		RemoveCellAt(index);
+
+		FireSpreadSpawner spawner = m_mSpawners.Get(spawnerId);
+		if (spawner)
+			spawner.OnNodeDied(cellId, slot);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void RemoveCellAt(int index)
+	{
+		int last = m_aCellId.Count() - 1;
+		m_mCellIndex.Remove(m_aCellId[index]);
+		RemoveFromBucket(m_aCellId[index], m_aCellPos[index]);
+
+		if (index != last)
+		{
+			m_aCellId[index]         = m_aCellId[last];
+			m_aCellPos[index]        = m_aCellPos[last];
+			m_aCellAge[index]        = m_aCellAge[last];
+			m_aCellIntensity[index]  = m_aCellIntensity[last];
+			m_aCellSpawner[index]    = m_aCellSpawner[last];
+			m_aCellSlot[index]       = m_aCellSlot[last];
+			m_aCellTemplate[index]   = m_aCellTemplate[last];
+			m_aCellNextDamage[index] = m_aCellNextDamage[last];
+			m_mCellIndex.Set(m_aCellId[index], index);
+		}
+
+		m_aCellId.Remove(last);
+		m_aCellPos.Remove(last);
+		m_aCellAge.Remove(last);
+		m_aCellIntensity.Remove(last);
+		m_aCellSpawner.Remove(last);
+		m_aCellSlot.Remove(last);
+		m_aCellTemplate.Remove(last);
+		m_aCellNextDamage.Remove(last);
+	}
+}
@@ -0,0 +1,297 @@
+// FireSpreadGrid.c
+//
+// Cellular fire spread on a sparse 2D grid shared by every spawner.
+// Each 1 m cell remembers its surface point, fuel and moisture (from the spreading spawner's
+// FireMaterialRule for the surface material) and whether it is unburnt, burning or burnt.
+// Only burning cells — the fire front — are visited each step, so spread cost follows the front
+// instead of entity queries, and fires from different impacts merge where they meet.
+//
+// Server only. Driven by FireSimulationManager's tick.
+
+enum EFireGridState
+{
+	UNBURNT,
+	BURNING,
+	BURNT
+}
+
+class FireSpreadGrid
+{
+	static const float CELL_SIZE     = 1.0;		// metres
+	static const float STEP_INTERVAL = 0.5;		// seconds between spread steps
+
+	protected static const float BASE_SPREAD_CHANCE = 0.25;	// per neighbour per step at full fuel, no moisture, spawner interval = STEP_INTERVAL
+	protected static const float DIRECTION_BIAS     = 0.75;	// how strongly the spawner's (wind-blended) forward favours downwind neighbours
+	protected static const float DIAGONAL_WEIGHT    = 0.7;
+	protected static const float FORGET_AFTER       = 120.0;	// seconds until a burnt or never-lit cell is dropped and can burn again
+	protected static const float PROBE_UP           = 1.5;		// surface probe starts this far above the neighbour's height...
+	protected static const float PROBE_DOWN         = 3.0;		// ...and ends this far below it
+	protected static const float POS_JITTER         = 0.3;		// random offset inside the cell so flames don't line up
+
+	// Cells — struct of arrays, all index-aligned. Removal moves the last cell into the hole.
+	protected ref array<int>    m_aKey      = new array<int>();
+	protected ref array<vector> m_aPos      = new array<vector>();
+	protected ref array<float>  m_aFuel     = new array<float>();
+	protected ref array<float>  m_aMoisture = new array<float>();
+	protected ref array<int>    m_aState    = new array<int>();
+	protected ref array<int>    m_aFireCell = new array<int>();	// FireSimulationManager cell id while burning
+	protected ref array<int>    m_aSpawner  = new array<int>();	// spawner that owns the burning cell
+	protected ref map<int, int> m_mIndex    = new map<int, int>();	// grid key -> index
+
+	protected ref array<int> m_aFrontier = new array<int>();	// keys of burning cells
+	protected ref FireQueue<int, float> m_ForgetQueue = new FireQueue<int, float>();	// key, time to drop it — oldest first
+
+	protected float m_fTime;
+	protected ref TraceParam m_Trace = new TraceParam();
+
+	//------------------------------------------------------------------------------------------------
+	int GetCellCount()
+	{
+		return m_aKey.Count();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	int GetFrontierCount()
+	{
+		return m_aFrontier.Count();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// Marks the cell under pos as burning with an already ignited fire cell (the impact itself).
+	void IgniteAt(vector pos, int fireCellId, int spawnerId, float fuel, float moisture)
+	{
+		int x = Math.Floor(pos[0] / CELL_SIZE);
+		int z = Math.Floor(pos[2] / CELL_SIZE);
+		int key = MakeKey(x, z);
+
+		int index;
+		if (!m_mIndex.Find(key, index))
+			index = AddCell(key, pos, fuel, moisture);
+		else if (m_aState[index] == EFireGridState.BURNING)
+			return;
+
+		SetBurning(index, fireCellId, spawnerId);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// One spread step over the fire front.
+	void Step(BaseWorld world)
+	{
+		m_fTime += STEP_INTERVAL;
+		ForgetExpired();
+
+		FireSimulationManager manager = FireSimulationManager.GetInstance();
+
+		// Backwards over the front as it was at the start of the step — cells lit now wait for the next step.
+		for (int i = m_aFrontier.Count() - 1; i >= 0; i--)
+		{
+			int key = m_aFrontier[i];
+			int index;
+			if (!m_mIndex.Find(key, index))
+			{
+				RemoveFrontierAt(i);
+				continue;
+			}
+
+			if (!manager.IsBurning(m_aFireCell[index]))
+			{
+				m_aState[index] = EFireGridState.BURNT;
+				m_aFireCell[index] = 0;
+				ScheduleForget(key);
+				RemoveFrontierAt(i);
+				continue;
+			}
+
+			FireSpreadSpawner spawner = manager.GetSpawner(m_aSpawner[index]);
+			if (!spawner || !spawner.CanSpread())
+				continue;
+
+			SpreadFrom(world, index, spawner);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void SpreadFrom(BaseWorld world, int index, FireSpreadSpawner spawner)
+	{
+		vector origin = m_aPos[index];
+		int cx = Math.Floor(origin[0] / CELL_SIZE);
+		int cz = Math.Floor(origin[2] / CELL_SIZE);
+
+		vector forward = spawner.GetSpreadDirection();
+		float fx = forward[0];
+		float fz = forward[2];
+		float fLen = Math.Sqrt(fx * fx + fz * fz);
+		if (fLen > 0.0001)
+		{
+			fx = fx / fLen;
+			fz = fz / fLen;
+		}
+
+		float rate = BASE_SPREAD_CHANCE * STEP_INTERVAL / Math.Max(spawner.GetSpreadInterval(), 0.05);
+
+		for (int dx = -1; dx <= 1; dx++)
+		{
+			for (int dz = -1; dz <= 1; dz++)
+			{
+				if (dx == 0 && dz == 0)
+					continue;
+
+				float dirWeight = 1.0;
+				if (dx != 0 && dz != 0)
+					dirWeight = DIAGONAL_WEIGHT;
+
+				// Downwind / forward neighbours are favoured, upwind ones still burn slowly.
+				float invLen = 1.0 / Math.Sqrt(dx * dx + dz * dz);
+				float along = (dx * fx + dz * fz) * invLen;
+				dirWeight *= Math.Clamp(1.0 + DIRECTION_BIAS * along, 0.1, 2.0);
+
+				int key = MakeKey(cx + dx, cz + dz);
+				int nIndex;
+				if (!m_mIndex.Find(key, nIndex))
+				{
+					nIndex = ProbeCell(world, key, cx + dx, cz + dz, origin[1], spawner);
+					if (nIndex < 0)
+						continue;
+				}
+
+				if (m_aState[nIndex] != EFireGridState.UNBURNT)
+					continue;
+
+				float chance = rate * dirWeight * m_aFuel[nIndex] * (1.0 - m_aMoisture[nIndex]);
+				if (Math.RandomFloat(0, 1) >= chance)
+					continue;
+
+				int fireCellId = spawner.SpawnFromGrid(m_aPos[nIndex]);
+				if (fireCellId == 0)
+					return;
+
+				SetBurning(nIndex, fireCellId, spawner.GetSpawnerId());
+
+				// The spawner may have just hit its own cap.
+				if (!spawner.CanSpread())
+					return;
+			}
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// Finds the surface in a new cell and reads its fuel. Cells without a surface are remembered
+	// with zero fuel so they aren't traced again. Returns the index, or -1 if nothing could be traced.
+	protected int ProbeCell(BaseWorld world, int key, int x, int z, float refY, FireSpreadSpawner spawner)
+	{
+		float px = (x + 0.5 + Math.RandomFloat(-POS_JITTER, POS_JITTER)) * CELL_SIZE;
+		float pz = (z + 0.5 + Math.RandomFloat(-POS_JITTER, POS_JITTER)) * CELL_SIZE;
+
+		m_Trace.Start   = Vector(px, refY + PROBE_UP, pz);
+		m_Trace.End     = Vector(px, refY - PROBE_DOWN, pz);
+		m_Trace.Flags   = TraceFlags.WORLD | TraceFlags.ENTS;
+		m_Trace.Exclude = spawner.GetOwner();
+		m_Trace.SurfaceProps = null;
+
+		FireStats.s_iTraces++;
+		float frac = world.TraceMove(m_Trace, null);
+		if (frac >= 1.0)
+		{
+			int emptyIndex = AddCell(key, Vector(px, refY, pz), 0, 1);
+			ScheduleForget(key);
+			return emptyIndex;
+		}
+
+		vector pos = m_Trace.Start + (m_Trace.End - m_Trace.Start) * frac;
+
+		float fuel;
+		float moisture;
+		spawner.GetSurfaceFuel(m_Trace.SurfaceProps, fuel, moisture);
+
+		int index = AddCell(key, pos, fuel, moisture);
+		ScheduleForget(key);
+		return index;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected int AddCell(int key, vector pos, float fuel, float moisture)
+	{
+		int index = m_aKey.Insert(key);
+		m_aPos.Insert(pos);
+		m_aFuel.Insert(fuel);
+		m_aMoisture.Insert(moisture);
+		m_aState.Insert(EFireGridState.UNBURNT);
+		m_aFireCell.Insert(0);
+		m_aSpawner.Insert(0);
+		m_mIndex.Insert(key, index);
+		return index;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void SetBurning(int index, int fireCellId, int spawnerId)
+	{
+		m_aState[index]    = EFireGridState.BURNING;
+		m_aFireCell[index] = fireCellId;
+		m_aSpawner[index]  = spawnerId;
+		m_aFrontier.Insert(m_aKey[index]);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void RemoveFrontierAt(int i)
+	{
+		int last = m_aFrontier.Count() - 1;
+		m_aFrontier[i] = m_aFrontier[last];
+		m_aFrontier.Remove(last);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void ScheduleForget(int key)
+	{
+		m_ForgetQueue.Push(key, m_fTime + FORGET_AFTER);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// Drops remembered cells whose time is up, unless they are burning right now (they are
+	// re-scheduled when they burn out).
+	protected void ForgetExpired()
+	{
+		while (!m_ForgetQueue.IsEmpty() && m_ForgetQueue.PeekValue() <= m_fTime)
+		{
+			int key = m_ForgetQueue.Pop();
+
+			int index;
+			if (m_mIndex.Find(key, index) && m_aState[index] != EFireGridState.BURNING)
+				RemoveCellAt(index);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void RemoveCellAt(int index)
+	{
+		int last = m_aKey.Count() - 1;
+		m_mIndex.Remove(m_aKey[index]);
+
+		if (index != last)
+		{
+			m_aKey[index]      = m_aKey[last];
+			m_aPos[index]      = m_aPos[last];
+			m_aFuel[index]     = m_aFuel[last];
+			m_aMoisture[index] = m_aMoisture[last];
+			m_aState[index]    = m_aState[last];
+			m_aFireCell[index] = m_aFireCell[last];
+			m_aSpawner[index]  = m_aSpawner[last];
+			m_mIndex.Set(m_aKey[index], index);
+		}
+
+		m_aKey.Remove(last);
+		m_aPos.Remove(last);
+		m_aFuel.Remove(last);
+		m_aMoisture.Remove(last);
+		m_aState.Remove(last);
+		m_aFireCell.Remove(last);
+		m_aSpawner.Remove(last);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// 16 bits per axis — unique within ±32 km of the world origin at 1 m cells.
+	// FireSimulationManager buckets every burning cell by the same keys.
+	static int MakeKey(int x, int z)
+	{
+		return ((x & 0xFFFF) << 16) | (z & 0xFFFF);
+	}
+}
@@ -10,6 +10,75 @@ class FireMaterialRule
 	[Attribute("8", UIWidgets.EditBox, "Maximum fire nodes spawned on this surface per impact. A random value between min and max is picked each time.")]
 	int m_iMaxNodes;
 
+	[Attribute("0.6", UIWidgets.Slider, "Grid spread: how readily fire spreads onto this surface. 0 = never catches fire.", params: "0 1 0.05")]
+	float m_fFuel;
+
+	[Attribute("0.2", UIWidgets.Slider, "Grid spread: surface moisture. Lowers the chance fire spreads onto this surface.", params: "0 1 0.05")]
+	float m_fMoisture;
+
+}
+
+//------------------------------------------------------------------------------------------------
+// Surface material -> FireMaterialRule index for one set of rules, filled in lazily.
+// Shared by every spawner of the same prefab, so each material name is lowercased and matched
+// once per process and later impacts on it are a single map lookup.
+class FireMaterialLookup
+{
+	protected ref array<string> m_aSubstrings = new array<string>();	// lowercased, index-aligned with the rules
+	protected ref map<GameMaterial, int> m_mRuleIndex = new map<GameMaterial, int>();	// -1 = no rule matches
+
+	protected static ref map<EntityPrefabData, ref FireMaterialLookup> s_mByPrefab = new map<EntityPrefabData, ref FireMaterialLookup>();
+
+	//------------------------------------------------------------------------------------------------
+	// Lookup shared by spawners of the same prefab. Spawners without prefab data get their own.
+	static FireMaterialLookup Get(EntityPrefabData prefabData, notnull array<ref FireMaterialRule> rules)
+	{
+		FireMaterialLookup lookup;
+		if (prefabData && s_mByPrefab.Find(prefabData, lookup))
+			return lookup;
+
+		lookup = new FireMaterialLookup(rules);
+		if (prefabData)
+			s_mByPrefab.Insert(prefabData, lookup);
+		return lookup;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	void FireMaterialLookup(notnull array<ref FireMaterialRule> rules)
+	{
+		foreach (FireMaterialRule rule : rules)
+		{
+			string sub = rule.m_sMatSubstring;
+			sub.ToLower();
+			m_aSubstrings.Insert(sub);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// Index of the first rule whose substring appears in the material name (case-insensitive), or -1.
+	int FindRuleIndex(notnull GameMaterial material)
+	{
+		int index;
+		if (m_mRuleIndex.Find(material, index))
+			return index;
+
+		string matName = material.GetName();
+		matName.ToLower();
+
+		index = -1;
+		for (int i = 0; i < m_aSubstrings.Count(); i++)
+		{
+			string sub = m_aSubstrings[i];
+			if (!sub.IsEmpty() && matName.IndexOf(sub) != -1)
+			{
+				index = i;
+				break;
+			}
+		}
+
+		m_mRuleIndex.Insert(material, index);
+		return index;
+	}
 }
 
 [ComponentEditorProps(category: "WW2Vehicles/Projectile", description: "Spawns fire node prefabs spreading outward from the impact point.")]
@@ -17,7 +86,7 @@ class FireSpreadSpawnerClass : ScriptComponentClass {}
 
 class FireSpreadSpawner : ScriptComponent
 {
-	[Attribute("", UIWidgets.ResourcePickerThumbnail, "The FireSpreadNode entity prefab (.et) to place at each fire position.", params: "et")]
+	[Attribute("", UIWidgets.ResourcePickerThumbnail, "The FireSpreadNode entity prefab (.et) whose settings are used for each fire cell. The prefab itself is not spawned.", params: "et")]
 	protected ResourceName m_rPrefab;
 
 	[Attribute("5", UIWidgets.EditBox, "Minimum number of fire nodes to spawn when the surface material matches no rule.")]
@@ -56,6 +125,9 @@ class FireSpreadSpawner : ScriptComponent
 	[Attribute("5.0", UIWidgets.EditBox, "How far (metres) to raycast along the surface normal to find the surface when placing each node. Keeps nodes stuck to walls, floors and slopes. Set to 0 to disable.")]
 	protected float m_fSurfaceSnapDist;
 
+	[Attribute("8", UIWidgets.EditBox, "Chain spread: how many upcoming node positions are computed and snapped to the surface in one batch. Spawn ticks then need no trace.")]
+	protected int m_iPathBatchSize;
+
 	[Attribute("2.0", UIWidgets.EditBox, "Before placing each node (after the first two), the spawner checks this radius (metres) for an existing fire node nearby. If none found, it waits. Set to 0 to always place immediately.")]
 	protected float m_fProximityRadius;
 
@@ -65,9 +137,24 @@ class FireSpreadSpawner : ScriptComponent
 	[Attribute("999999", UIWidgets.EditBox, "Damage applied to trees within the vegetation radius. Set high enough to fell the tree in one hit, or lower to just damage it.")]
 	protected float m_fTreeDamage;
 
+	[Attribute("2", UIWidgets.EditBox, "Trees found around fire nodes are felled through a shared queue, at most this many per frame across all fires.")]
+	protected int m_iTreesPerFrame;
+
 	[Attribute("1.0", UIWidgets.Slider, "How much the wind direction influences the spread direction. 0 = impact direction only, 1 = full wind direction.", params: "0.0 1.0 0.05")]
 	protected float m_fWindInfluence;
 
+	[Attribute("150", UIWidgets.EditBox, "Server-wide limit on burning fire nodes across all impacts. When full, new nodes only replace lower-priority ones (far from players, old, or from impacts with many nodes). 0 = no limit.")]
+	protected int m_iGlobalBudget;
+
+	[Attribute("1", UIWidgets.CheckBox, "Spread over the shared 1 m fire grid, using fuel and moisture from the material rules. Fires from different impacts merge. Off (or steep surfaces like walls) = random-walk chain.")]
+	protected bool m_bGridSpread;
+
+	[Attribute("0.5", UIWidgets.Slider, "Grid spread: fuel of surfaces that match no material rule.", params: "0 1 0.05")]
+	protected float m_fDefaultFuel;
+
+	[Attribute("0.2", UIWidgets.Slider, "Grid spread: moisture of surfaces that match no material rule.", params: "0 1 0.05")]
+	protected float m_fDefaultMoisture;
+
 	[Attribute()]
 	protected ref array<ref FireMaterialRule> m_aMaterialRules;
 
@@ -77,8 +164,18 @@ class FireSpreadSpawner : ScriptComponent
 	protected int    m_iSpawned;		// total nodes placed so far
 	protected int    m_iAlive;			// nodes from this impact that are still burning
 	protected int    m_iLocalCap;		// total node cap for this impact, rolled from material rule
-	protected ref Resource m_NodeRes;	// cached prefab resource — avoids Resource.Load on every spawn
-	protected ref array<IEntity> m_aLiveNodes = new array<IEntity>();		// oldest-first list of alive node entities
+	protected FireCellTemplate m_NodeTemplate;	// node prefab settings, shared by every spawner using the prefab
+	protected int    m_iSpawnerId;		// id in FireSimulationManager, 0 = not registered
+
+	// Alive cells, oldest first — a doubly linked list over index-stable slots. Each cell carries its
+	// slot (given to FireSimulationManager.Ignite), so death and oldest-eviction are O(1).
+	protected ref array<int> m_aSlotCell = new array<int>();	// cell id, 0 = free slot
+	protected ref array<int> m_aSlotPrev = new array<int>();
+	protected ref array<int> m_aSlotNext = new array<int>();	// also chains the free list
+	protected int    m_iOldestSlot = -1;
+	protected int    m_iNewestSlot = -1;
+	protected int    m_iFreeSlot   = -1;
+
 	protected ref set<IEntity> m_sDamagedTrees = new set<IEntity>();		// trees already hit — skip on repeat queries
 	protected vector m_vLastPos;
 	protected vector m_vForward;
@@ -86,20 +183,51 @@ class FireSpreadSpawner : ScriptComponent
 	protected vector m_vSurfaceNormal;
 	protected vector m_vNextPos;
 	protected bool   m_bNextPosReady;
-	protected bool   m_bFoundNearbyFire;
+	protected vector m_vPathTail;		// last pre-computed chain position — the next batch continues from here
+	protected ref array<vector> m_aPathPos = new array<vector>();			// pre-computed, surface-snapped chain positions
+	protected ref array<GameMaterial> m_aPathMaterial = new array<GameMaterial>();	// surface under each, null if nothing was hit
+	protected int    m_iPathHead;
+	protected ref TraceParam m_SnapTrace = new TraceParam();	// reused by every surface trace of this spawner
+	protected float  m_fOriginFuel;		// fuel/moisture of the impact surface, for the first grid cell
+	protected float  m_fOriginMoisture;
+	protected FireMaterialLookup m_MaterialLookup;	// shared per spawner prefab, owned by FireMaterialLookup
+
+	// Grid spread only works on roughly horizontal ground — the grid is 2D.
+	protected static const float GRID_MIN_NORMAL_Y = 0.6;
 
 	protected ref array<ref Shape> m_aShapes = new array<ref Shape>();
 
+	protected bool m_bInitPending;		// Init is still in the call queue
+	protected bool m_bChainRunning;		// TrySpawnNext is repeating in the call queue
+	protected bool m_bRequesting;		// inside FireBudget.RequestAllowance, which may evict our last cell
+
+	// Set by FireBenchmark so runs are reproducible: a fixed downwind direction instead of the
+	// weather, and no per-spawn debug output skewing frame times.
+	protected static bool   s_bBenchmarkMode;
+	protected static vector s_vBenchmarkWind;
+
+	//------------------------------------------------------------------------------------------------
+	static void SetBenchmarkMode(bool enabled, vector downwind)
+	{
+		s_bBenchmarkMode = enabled;
+		s_vBenchmarkWind = downwind;
+	}
+
 	//------------------------------------------------------------------------------------------------
 	override protected void OnPostInit(IEntity owner)
 	{
 		super.OnPostInit(owner);
+		m_bInitPending = true;
+		FireStats.s_iScheduled++;
 		GetGame().GetCallqueue().CallLater(Init, 500, false);
 	}
 
 	//------------------------------------------------------------------------------------------------
 	protected void Init()
 	{
+		m_bInitPending = false;
+		FireStats.s_iScheduled--;
+
 		IEntity owner = GetOwner();
 		if (!owner)
 			return;
@@ -115,14 +243,18 @@ class FireSpreadSpawner : ScriptComponent
 			return;
 		}
 
-		// Cache resource once — reused in every DoSpawn call.
-		m_NodeRes = Resource.Load(m_rPrefab);
-		if (!m_NodeRes || !m_NodeRes.IsValid())
+		// Node settings are read from the prefab once per prefab, not per impact.
+		m_NodeTemplate = FireCellTemplate.Get(m_rPrefab);
+		if (!m_NodeTemplate)
 		{
 			Print("[FireSpreadSpawner] Resource load failed!", LogLevel.ERROR);
 			return;
 		}
 
+		m_iSpawnerId = FireSimulationManager.GetInstance().RegisterSpawner(this);
+		FireVegetationQueue.GetInstance().SetTreesPerFrame(m_iTreesPerFrame);
+		FireBudget.GetInstance().SetBudget(m_iGlobalBudget);
+
 		vector mat[4];
 		owner.GetWorldTransform(mat);
 
@@ -143,9 +275,17 @@ class FireSpreadSpawner : ScriptComponent
 		if (m_vRight.LengthSq() < 0.01)
 			m_vRight = Vector(0, 0, 1);
 
+		if (s_bBenchmarkMode)
+			m_bDebug = false;
+
 		// Blend impact direction with wind direction based on m_fWindInfluence (0=impact, 1=wind).
 		// Uses LocalWeatherSituation.GetLocalWindSway() — returns a world-space vector directly.
-		if (m_fWindInfluence > 0)
+		if (m_fWindInfluence > 0 && s_bBenchmarkMode)
+		{
+			if (s_vBenchmarkWind.LengthSq() > 0.0001)
+				BlendWind(s_vBenchmarkWind.Normalized());
+		}
+		else if (m_fWindInfluence > 0)
 		{
 			ChimeraWorld cworld = ChimeraWorld.CastFrom(owner.GetWorld());
 			if (cworld)
@@ -169,23 +309,7 @@ class FireSpreadSpawner : ScriptComponent
 						if (wLen > 0.0001)
 						{
 							// Negate — sway points INTO the wind; we want the downwind direction.
-							vector windVec = Vector(-(wx / wLen), 0, -(wz / wLen));
-
-							// Project onto surface plane.
-							windVec = windVec - m_vSurfaceNormal * (windVec * m_vSurfaceNormal);
-							if (windVec.LengthSq() > 0.0001)
-								windVec = windVec.Normalized();
-
-							// Blend: m_fWindInfluence=0 keeps impact dir, 1 uses pure wind dir.
-							vector blended = m_vForward * (1.0 - m_fWindInfluence) + windVec * m_fWindInfluence;
-							if (blended.LengthSq() > 0.0001)
-								m_vForward = blended.Normalized();
-
-							vector f = m_vForward;
-							vector n = m_vSurfaceNormal;
-							vector cross = Vector(f[2]*n[1] - f[1]*n[2], f[0]*n[2] - f[2]*n[0], f[1]*n[0] - f[0]*n[1]);
-							if (cross.LengthSq() > 0.0001)
-								m_vRight = cross.Normalized();
+							BlendWind(Vector(-(wx / wLen), 0, -(wz / wLen)));
 
 							if (m_bDebug)
 								Print("[FireSpreadSpawner] Wind influence " + m_fWindInfluence + " — blended forward: " + m_vForward, LogLevel.WARNING);
@@ -197,8 +321,14 @@ class FireSpreadSpawner : ScriptComponent
 			}
 		}
 
-		vector origin   = owner.GetOrigin();
-		m_vLastPos      = SnapToSurface(origin, owner.GetWorld());
+		// One trace at the origin gives both the first node position and the surface for the caps.
+		vector origin = owner.GetOrigin();
+		GameMaterial originMaterial;
+		if (!TraceSurface(origin, owner.GetWorld(), m_vLastPos, originMaterial))
+			m_vLastPos = origin;
+
+		m_vPathTail     = m_vLastPos;
+		FireBudget.GetInstance().RegisterSpawner(m_iSpawnerId, m_vLastPos);
 		m_iSpawned      = 0;
 		m_iAlive        = 0;
 		m_bNextPosReady = false;
@@ -212,78 +342,216 @@ class FireSpreadSpawner : ScriptComponent
 				Print("[FireSpreadSpawner] Proximity radius too small — auto-adjusted to " + m_fProximityRadius, LogLevel.WARNING);
 		}
 
-		ResolveCaps(origin, owner.GetWorld());
+		ResolveCaps(originMaterial);
 
 		if (m_bDebug)
 			Print("[FireSpreadSpawner] Surface cap: " + m_iLocalCap + " total, soft cap: " + m_iMaxAlive + ", hard cap: " + m_iHardCap, LogLevel.WARNING);
 
 		if (m_iLocalCap == 0)
+		{
+			RetireIfDone();
 			return;
+		}
 
 		// First node seeds the chain immediately.
-		DoSpawn(owner, m_vLastPos);
+		int firstCell = DoSpawn(owner, m_vLastPos);
 
+		// Grid spread is driven by FireSimulationManager from here on.
+		if (m_bGridSpread && m_vSurfaceNormal[1] >= GRID_MIN_NORMAL_Y)
+		{
+			if (firstCell != 0)
+				FireSimulationManager.GetInstance().GetGrid().IgniteAt(m_vLastPos, firstCell, m_iSpawnerId, m_fOriginFuel, m_fOriginMoisture);
+			else
+				RetireIfDone();
+			return;
+		}
+
+		m_bChainRunning = true;
+		FireStats.s_iScheduled++;
 		GetGame().GetCallqueue().CallLater(TrySpawnNext, m_fInterval * 1000, true);
 	}
 
 	//------------------------------------------------------------------------------------------------
-	// Called by a node just before it deletes itself.
-	void OnNodeDied(IEntity nodeEnt)
+	// Turns the spread direction towards a horizontal downwind direction, by m_fWindInfluence.
+	protected void BlendWind(vector windVec)
+	{
+		// Project onto surface plane.
+		windVec = windVec - m_vSurfaceNormal * (windVec * m_vSurfaceNormal);
+		if (windVec.LengthSq() > 0.0001)
+			windVec = windVec.Normalized();
+
+		// Blend: m_fWindInfluence=0 keeps impact dir, 1 uses pure wind dir.
+		vector blended = m_vForward * (1.0 - m_fWindInfluence) + windVec * m_fWindInfluence;
+		if (blended.LengthSq() > 0.0001)
+			m_vForward = blended.Normalized();
+
+		vector f = m_vForward;
+		vector n = m_vSurfaceNormal;
+		vector cross = Vector(f[2]*n[1] - f[1]*n[2], f[0]*n[2] - f[2]*n[0], f[1]*n[0] - f[0]*n[1]);
+		if (cross.LengthSq() > 0.0001)
+			m_vRight = cross.Normalized();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	int GetSpawnerId()
+	{
+		return m_iSpawnerId;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	int GetAliveCount()
+	{
+		return m_iAlive;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// Grid spread: false once this impact placed its total cap or reached the soft cap.
+	bool CanSpread()
+	{
+		if (!m_NodeTemplate || m_iSpawned >= m_iLocalCap)
+			return false;
+		return m_iMaxAlive <= 0 || m_iAlive < m_iMaxAlive;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// Grid spread: places a node the grid decided to ignite. Returns its cell id, 0 on failure.
+	int SpawnFromGrid(vector pos)
+	{
+		IEntity owner = GetOwner();
+		if (!owner)
+			return 0;
+		return DoSpawn(owner, pos);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// Impact direction blended with the wind in Init.
+	vector GetSpreadDirection()
+	{
+		return m_vForward;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	float GetSpreadInterval()
+	{
+		return m_fInterval;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// Grid spread: fuel and moisture of a surface from the matching rule, or the defaults.
+	void GetSurfaceFuel(GameMaterial material, out float fuel, out float moisture)
+	{
+		FireMaterialRule rule = FindMaterialRule(material);
+		if (rule)
+		{
+			fuel = rule.m_fFuel;
+			moisture = rule.m_fMoisture;
+			return;
+		}
+
+		fuel = m_fDefaultFuel;
+		moisture = m_fDefaultMoisture;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// Called by FireSimulationManager when one of this spawner's cells burns out.
+	void OnNodeDied(int cellId, int slot)
 	{
 		m_iAlive--;
 		if (m_iAlive < 0)
 			m_iAlive = 0;
-		if (nodeEnt)
-			m_aLiveNodes.RemoveItem(nodeEnt);
+		ReleaseSlot(cellId, slot);
 		if (m_bDebug)
 			Print("[FireSpreadSpawner] Node died. Alive: " + m_iAlive + " / " + m_iMaxAlive, LogLevel.WARNING);
+
+		RetireIfDone();
 	}
 
 	//------------------------------------------------------------------------------------------------
-	protected void ResolveCaps(vector pos, BaseWorld world)
+	// Called by FireSimulationManager when FireBudget removed one of this spawner's cells for a
+	// higher-priority node. The manager has already removed the cell and told the clients.
+	void OnNodeEvicted(int cellId, int slot)
 	{
-		if (!m_aMaterialRules || m_aMaterialRules.Count() == 0 || m_fSurfaceSnapDist <= 0)
-		{
-			m_iLocalCap = RandRange(m_iCountMin, m_iCountMax);
+		m_iAlive--;
+		if (m_iAlive < 0)
+			m_iAlive = 0;
+		ReleaseSlot(cellId, slot);
+
+		if (m_bDebug)
+			Print("[FireSpreadSpawner] Node evicted by the global fire budget. Alive: " + m_iAlive, LogLevel.WARNING);
+
+		RetireIfDone();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// Nothing left to place and nothing of this impact burning: leaves the manager and the budget,
+	// so a finished impact no longer holds a row in either or keeps the budget's refresh running.
+	// Grid spread only continues from burning cells, so with none alive it cannot place more.
+	protected void RetireIfDone()
+	{
+		if (m_iSpawnerId == 0 || m_bChainRunning || m_bRequesting || m_iAlive > 0)
 			return;
-		}
 
-		vector from = pos + m_vSurfaceNormal * 0.5;
-		vector to   = pos - m_vSurfaceNormal * m_fSurfaceSnapDist;
+		if (m_bDebug)
+			Print("[FireSpreadSpawner] Impact burnt out after " + m_iSpawned + " nodes — unregistering.", LogLevel.WARNING);
 
-		TraceParam tp = new TraceParam();
-		tp.Start   = from;
-		tp.End     = to;
-		tp.Flags   = TraceFlags.WORLD | TraceFlags.ENTS;
-		tp.Exclude = GetOwner();
+		Unregister();
+	}
 
-		float frac = world.TraceMove(tp, null);
-		if (frac >= 1.0 || !tp.SurfaceProps)
+	//------------------------------------------------------------------------------------------------
+	protected void Unregister()
+	{
+		if (m_iSpawnerId == 0)
+			return;
+
+		FireSimulationManager.GetInstance().UnregisterSpawner(m_iSpawnerId);
+		FireBudget.GetInstance().UnregisterSpawner(m_iSpawnerId);
+		m_iSpawnerId = 0;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void ResolveCaps(GameMaterial material)
+	{
+		m_fOriginFuel     = m_fDefaultFuel;
+		m_fOriginMoisture = m_fDefaultMoisture;
+
+		if (!material || !m_aMaterialRules || m_aMaterialRules.Count() == 0)
 		{
 			m_iLocalCap = RandRange(m_iCountMin, m_iCountMax);
 			return;
 		}
 
-		string matName = tp.SurfaceProps.GetName();
-		matName.ToLower();
-
 		if (m_bDebug)
-			Print("[FireSpreadSpawner] Surface material: " + matName, LogLevel.WARNING);
+			Print("[FireSpreadSpawner] Surface material: " + material.GetName(), LogLevel.WARNING);
 
-		foreach (FireMaterialRule rule : m_aMaterialRules)
+		FireMaterialRule rule = FindMaterialRule(material);
+		if (rule)
 		{
-			string sub = rule.m_sMatSubstring;
-			sub.ToLower();
-			if (!sub.IsEmpty() && matName.IndexOf(sub) != -1)
-			{
-				m_iLocalCap = RandRange(rule.m_iMinNodes, rule.m_iMaxNodes);
-				return;
-			}
+			m_iLocalCap       = RandRange(rule.m_iMinNodes, rule.m_iMaxNodes);
+			m_fOriginFuel     = rule.m_fFuel;
+			m_fOriginMoisture = rule.m_fMoisture;
+			return;
 		}
 
 		m_iLocalCap = RandRange(m_iCountMin, m_iCountMax);
 	}
 
+	//------------------------------------------------------------------------------------------------
+	// First rule whose substring appears in the material name (case-insensitive), or null.
+	protected FireMaterialRule FindMaterialRule(GameMaterial material)
+	{
+		if (!material || !m_aMaterialRules || m_aMaterialRules.IsEmpty())
+			return null;
+
+		if (!m_MaterialLookup)
+			m_MaterialLookup = FireMaterialLookup.Get(GetOwner().GetPrefabData(), m_aMaterialRules);
+
+		int index = m_MaterialLookup.FindRuleIndex(material);
+		if (index < 0 || index >= m_aMaterialRules.Count())
+			return null;
+
+		return m_aMaterialRules[index];
+	}
+
 	//------------------------------------------------------------------------------------------------
 	protected int RandRange(int minVal, int maxVal)
 	{
@@ -297,7 +565,8 @@ class FireSpreadSpawner : ScriptComponent
 	{
 		if (m_iSpawned >= m_iLocalCap)
 		{
-			GetGame().GetCallqueue().Remove(TrySpawnNext);
+			StopChain();
+			RetireIfDone();
 			return;
 		}
 
@@ -313,8 +582,56 @@ class FireSpreadSpawner : ScriptComponent
 			return;
 		}
 
-		// Compute candidate position once, hold it until the proximity check passes.
+		// Take the next pre-computed candidate, hold it until the proximity check passes.
 		if (!m_bNextPosReady)
+		{
+			if (m_iPathHead >= m_aPathPos.Count())
+				RefillPath(owner.GetWorld());
+
+			m_vNextPos      = m_aPathPos[m_iPathHead];
+			GameMaterial nextMaterial = m_aPathMaterial[m_iPathHead];
+			m_iPathHead++;
+			m_bNextPosReady = true;
+
+			if (m_bDebug && nextMaterial)
+				Print("[FireSpreadSpawner] Next node surface: " + nextMaterial.GetName(), LogLevel.WARNING);
+
+			if (m_bDebug && m_fProximityRadius > 0)
+				m_aShapes.Insert(Shape.CreateSphere(ARGB(120, 0, 200, 255), ShapeFlags.VISIBLE | ShapeFlags.WIREFRAME, m_vNextPos, m_fProximityRadius));
+		}
+
+		// Proximity check — skip for first two nodes, as when nodes were entities.
+		if (m_fProximityRadius > 0 && m_iSpawned >= 2)
+		{
+			if (!FireSimulationManager.GetInstance().HasCellNear(m_vNextPos, m_fProximityRadius))
+			{
+				// The chain burnt out behind the candidate — nothing of ours can ever get close again.
+				if (m_iAlive == 0)
+				{
+					StopChain();
+					RetireIfDone();
+				}
+				return;
+			}
+		}
+
+		// Denied by the global budget — keep the candidate and retry next interval.
+		if (DoSpawn(owner, m_vNextPos) != 0)
+			m_bNextPosReady = false;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// Walks the next batch of chain positions from the end of the previous batch and snaps them all
+	// to the surface in one pass. Each step drifts the direction, steps forward and sideways —
+	// the same random walk as placing one node at a time, just computed ahead.
+	protected void RefillPath(BaseWorld world)
+	{
+		m_aPathPos.Clear();
+		m_aPathMaterial.Clear();
+		m_iPathHead = 0;
+
+		int count = Math.Min(Math.Max(m_iPathBatchSize, 1), Math.Max(m_iLocalCap - m_iSpawned, 1));
+		for (int k = 0; k < count; k++)
 		{
 			// Randomly rotate the spread direction slightly each step to create organic curves.
 			if (m_fDirDriftMax > 0)
@@ -344,139 +661,89 @@ class FireSpreadSpawner : ScriptComponent
 				lateralSign = -1;
 			float lateral = Math.RandomFloat(m_fDeviationMin, m_fDeviationMax) * lateralSign;
 
-			m_vNextPos = m_vLastPos
+			vector candidate = m_vPathTail
 				+ m_vForward * step
 				+ m_vRight   * lateral;
 
-			m_vNextPos      = SnapToSurface(m_vNextPos, owner.GetWorld());
-			m_bNextPosReady = true;
+			vector snapped;
+			GameMaterial material;
+			if (!TraceSurface(candidate, world, snapped, material))
+				snapped = candidate;
 
-			if (m_bDebug && m_fProximityRadius > 0)
-				m_aShapes.Insert(Shape.CreateSphere(ARGB(120, 0, 200, 255), ShapeFlags.VISIBLE | ShapeFlags.WIREFRAME, m_vNextPos, m_fProximityRadius));
+			m_aPathPos.Insert(snapped);
+			m_aPathMaterial.Insert(material);
+			m_vPathTail = snapped;
 		}
-
-		// Proximity check — skip for first two nodes (entity not yet queryable right after spawn).
-		if (m_fProximityRadius > 0 && m_iSpawned >= 2)
-		{
-			m_bFoundNearbyFire = false;
-			owner.GetWorld().QueryEntitiesBySphere(m_vNextPos, m_fProximityRadius, ProximityCallback, null, EQueryEntitiesFlags.ALL);
-
-			if (!m_bFoundNearbyFire)
-				return;
-		}
-
-		DoSpawn(owner, m_vNextPos);
-		m_bNextPosReady = false;
-	}
-
-	//------------------------------------------------------------------------------------------------
-	protected bool ProximityCallback(IEntity ent)
-	{
-		if (m_bFoundNearbyFire)
-			return false;
-
-		if (ent && ent.FindComponent(FireSpreadNode))
-		{
-			m_bFoundNearbyFire = true;
-			return false;
-		}
-
-		return true;
 	}
 
 	//------------------------------------------------------------------------------------------------
+	// Queues trees for felling — the damage itself is applied by FireVegetationQueue, a few per frame.
 	protected bool VegetationCallback(IEntity ent)
 	{
-		if (!ent)
-			return true;
-
-		EntityPrefabData pd = ent.GetPrefabData();
-		if (!pd)
+		// Trees only — bushes cannot be removed via script on dedicated server (engine limitation).
+		// The class check is cheaper than the prefab lookup, so it goes first.
+		BaseTree tree = BaseTree.Cast(ent);
+		if (!tree || m_sDamagedTrees.Contains(ent))
 			return true;
 
-		string fullPath = pd.GetPrefabName();
-		string pathLower = fullPath;
-		pathLower.ToLower();
-
-		if (!pathLower.Contains("prefabs/vegetation"))
+		if (!FireVegetationQueue.IsVegetationPrefab(ent))
 			return true;
 
-		// Trees only — use damage system so they fall over properly.
-		// Bushes cannot be removed via script on dedicated server (engine limitation).
-		BaseTree tree = BaseTree.Cast(ent);
-		if (tree)
-		{
-			if (m_sDamagedTrees.Contains(ent))
-				return true;
-			m_sDamagedTrees.Insert(ent);
-
-			if (m_bDebug)
-				Print("[FireSpreadSpawner] Felling tree: " + fullPath, LogLevel.WARNING);
+		m_sDamagedTrees.Insert(ent);
 
-			vector hitPosDirNorm[3];
-			hitPosDirNorm[0] = ent.GetOrigin();
-			hitPosDirNorm[1] = Vector(0, -1, 0);
-			hitPosDirNorm[2] = Vector(0, -1, 0);
-			tree.HandleDamage(EDamageType.FIRE, m_fTreeDamage, hitPosDirNorm);
-		}
+		if (FireVegetationQueue.GetInstance().Enqueue(tree, m_fTreeDamage) && m_bDebug)
+			Print("[FireSpreadSpawner] Queued tree for felling: " + ent.GetPrefabData().GetPrefabName(), LogLevel.WARNING);
 
 		return true;
 	}
 
 	//------------------------------------------------------------------------------------------------
-	protected void DoSpawn(IEntity owner, vector pos)
+	// Returns the new cell id, 0 if nothing was placed.
+	protected int DoSpawn(IEntity owner, vector pos)
 	{
-		if (!m_NodeRes || !m_NodeRes.IsValid())
-			return;
-
-		vector mat[4];
-		Math3D.MatrixIdentity4(mat);
-		mat[3] = pos;
+		if (!m_NodeTemplate || m_iSpawnerId == 0)
+			return 0;
 
-		EntitySpawnParams p = new EntitySpawnParams();
-		p.TransformMode = ETransformMode.WORLD;
-		p.Transform     = mat;
+		m_bRequesting = true;
+		bool allowed = FireBudget.GetInstance().RequestAllowance(m_iSpawnerId);
+		m_bRequesting = false;
 
-		IEntity e = GetGame().SpawnEntityPrefab(m_NodeRes, owner.GetWorld(), p);
-		if (!e)
+		if (!allowed)
 		{
-			Print("[FireSpreadSpawner] Spawn " + m_iSpawned + " failed!", LogLevel.ERROR);
-			return;
+			if (m_bDebug)
+				Print("[FireSpreadSpawner] Global fire budget full — node denied.", LogLevel.WARNING);
+			return 0;
 		}
 
-		// Register this spawner on the node so it can notify us when it dies.
-		FireSpreadNode node = FireSpreadNode.Cast(e.FindComponent(FireSpreadNode));
-		if (node)
-			node.SetOwnerSpawner(this);
+		int slot = AcquireSlot();
+		int cellId = FireSimulationManager.GetInstance().Ignite(m_NodeTemplate, pos, m_iSpawnerId, slot);
+		m_aSlotCell[slot] = cellId;
+
+		// Visuals on this machine, then on every client.
+		RpcDo_CellIgnited(cellId, pos);
+		Rpc(RpcDo_CellIgnited, cellId, pos);
 
-		m_aLiveNodes.Insert(e);
 		m_vLastPos = pos;
 		m_iSpawned++;
 		m_iAlive++;
 
 		// Hard cap — evict oldest nodes until we are back at or below the limit.
-		// Remove from m_aLiveNodes BEFORE deleting to prevent the OnNodeDied callback
-		// from modifying the array mid-iteration, which could loop forever.
+		// Extinguish doesn't report back through OnNodeDied, so m_iAlive is only decremented here.
 		if (m_iHardCap > 0)
 		{
-			while (m_iAlive > m_iHardCap && m_aLiveNodes.Count() > 0)
+			while (m_iAlive > m_iHardCap && m_iOldestSlot != -1)
 			{
-				IEntity oldest = m_aLiveNodes[0];
-				m_aLiveNodes.RemoveOrdered(0);
+				int oldest = m_aSlotCell[m_iOldestSlot];
+				ReleaseSlot(oldest, m_iOldestSlot);
 				m_iAlive--;
 
 				if (m_bDebug)
 					Print("[FireSpreadSpawner] Hard cap exceeded — evicting oldest node. Alive now: " + m_iAlive, LogLevel.WARNING);
 
-				// Zero the back-reference on the node before deleting so its OnDelete
-				// doesn't call OnNodeDied and double-decrement m_iAlive.
-				if (oldest)
+				if (FireSimulationManager.GetInstance().Extinguish(oldest))
 				{
-					FireSpreadNode evicted = FireSpreadNode.Cast(oldest.FindComponent(FireSpreadNode));
-					if (evicted)
-						evicted.m_OwnerSpawner = null;
-
-					SCR_EntityHelper.DeleteEntityAndChildren(oldest);
+					RpcDo_CellExtinguished(oldest);
+					Rpc(RpcDo_CellExtinguished, oldest);
 				}
 			}
 		}
@@ -487,49 +754,203 @@ class FireSpreadSpawner : ScriptComponent
 
 		if (m_bDebug)
 			m_aShapes.Insert(Shape.CreateSphere(ARGB(255, 255, 80, 0), ShapeFlags.VISIBLE | ShapeFlags.WIREFRAME, pos, 0.3));
+
+		return cellId;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// Takes a free slot (or grows the arrays) and links it as the newest live node.
+	protected int AcquireSlot()
+	{
+		int slot = m_iFreeSlot;
+		if (slot != -1)
+		{
+			m_iFreeSlot = m_aSlotNext[slot];
+		}
+		else
+		{
+			slot = m_aSlotCell.Insert(0);
+			m_aSlotPrev.Insert(-1);
+			m_aSlotNext.Insert(-1);
+		}
+
+		m_aSlotPrev[slot] = m_iNewestSlot;
+		m_aSlotNext[slot] = -1;
+		if (m_iNewestSlot != -1)
+			m_aSlotNext[m_iNewestSlot] = slot;
+		else
+			m_iOldestSlot = slot;
+		m_iNewestSlot = slot;
+
+		return slot;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// Unlinks the slot and puts it on the free list. Ignored if the slot no longer holds this cell.
+	protected void ReleaseSlot(int cellId, int slot)
+	{
+		if (slot < 0 || slot >= m_aSlotCell.Count() || m_aSlotCell[slot] != cellId)
+			return;
+
+		int prev = m_aSlotPrev[slot];
+		int next = m_aSlotNext[slot];
+		if (prev != -1)
+			m_aSlotNext[prev] = next;
+		else
+			m_iOldestSlot = next;
+		if (next != -1)
+			m_aSlotPrev[next] = prev;
+		else
+			m_iNewestSlot = prev;
+
+		m_aSlotCell[slot] = 0;
+		m_aSlotPrev[slot] = -1;
+		m_aSlotNext[slot] = m_iFreeSlot;
+		m_iFreeSlot = slot;
 	}
 
 	//------------------------------------------------------------------------------------------------
-	protected vector SnapToSurface(vector pos, BaseWorld world)
+	// Every machine: particle and decal for a newly ignited cell. Node settings come from this
+	// spawner's own m_rPrefab, so only the id and position travel.
+	[RplRpc(RplChannel.Reliable, RplRcver.Broadcast)]
+	protected void RpcDo_CellIgnited(int cellId, vector pos)
+	{
+		FireCellTemplate tmpl = FireCellTemplate.Get(m_rPrefab);
+		if (tmpl)
+			FireVisualManager.GetInstance().AddCell(cellId, pos, tmpl);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// Every machine: a cell was evicted before burning out. Natural burn-outs are timed locally.
+	[RplRpc(RplChannel.Reliable, RplRcver.Broadcast)]
+	protected void RpcDo_CellExtinguished(int cellId)
+	{
+		FireVisualManager.GetInstance().RemoveCell(cellId);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// Server: the cells of this impact that are still burning, for clients that join late or stream
+	// the spawner in after the ignitions were broadcast. Only id, position and remaining lifetime travel.
+	override bool RplSave(ScriptBitWriter writer)
+	{
+		if (!super.RplSave(writer))
+			return false;
+
+		FireSimulationManager manager = FireSimulationManager.GetInstance();
+		vector pos;
+		float remaining;
+
+		int count;
+		for (int slot = m_iOldestSlot; slot != -1; slot = m_aSlotNext[slot])
+		{
+			if (manager.GetCellState(m_aSlotCell[slot], pos, remaining))
+				count++;
+		}
+
+		writer.WriteInt(count);
+		for (int next = m_iOldestSlot; next != -1; next = m_aSlotNext[next])
+		{
+			int cellId = m_aSlotCell[next];
+			if (!manager.GetCellState(cellId, pos, remaining))
+				continue;
+
+			writer.WriteInt(cellId);
+			writer.WriteVector(pos);
+			writer.WriteFloat(remaining);
+		}
+
+		return true;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// Client: draws the burning cells from the server's snapshot. Cells already drawn are skipped.
+	override bool RplLoad(ScriptBitReader reader)
+	{
+		if (!super.RplLoad(reader))
+			return false;
+
+		int count;
+		if (!reader.ReadInt(count))
+			return false;
+
+		FireCellTemplate tmpl = FireCellTemplate.Get(m_rPrefab);
+		for (int i = 0; i < count; i++)
+		{
+			int cellId;
+			vector pos;
+			float remaining;
+			reader.ReadInt(cellId);
+			reader.ReadVector(pos);
+			reader.ReadFloat(remaining);
+
+			if (tmpl)
+				FireVisualManager.GetInstance().AddCell(cellId, pos, tmpl, remaining);
+		}
+
+		return true;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// Traces along the surface normal through pos with the spawner's reused TraceParam.
+	// Returns false (and leaves hitPos unset) if snapping is disabled or nothing was hit.
+	protected bool TraceSurface(vector pos, BaseWorld world, out vector hitPos, out GameMaterial material)
 	{
 		if (m_fSurfaceSnapDist <= 0)
-			return pos;
+			return false;
 
 		vector from = pos + m_vSurfaceNormal * 0.5;
 		vector to   = pos - m_vSurfaceNormal * m_fSurfaceSnapDist;
 
-		TraceParam tp = new TraceParam();
-		tp.Start   = from;
-		tp.End     = to;
-		tp.Flags   = TraceFlags.WORLD | TraceFlags.ENTS;
-		tp.Exclude = GetOwner();
+		m_SnapTrace.Start   = from;
+		m_SnapTrace.End     = to;
+		m_SnapTrace.Flags   = TraceFlags.WORLD | TraceFlags.ENTS;
+		m_SnapTrace.Exclude = GetOwner();
+		m_SnapTrace.SurfaceProps = null;
 
-		float frac = world.TraceMove(tp, null);
-		if (frac < 1.0)
-			return from + (to - from) * frac;
+		FireStats.s_iTraces++;
+		float frac = world.TraceMove(m_SnapTrace, null);
+		if (frac >= 1.0)
+			return false;
 
-		return pos;
+		hitPos   = from + (to - from) * frac;
+		material = m_SnapTrace.SurfaceProps;
+		return true;
 	}
 
 	//------------------------------------------------------------------------------------------------
-	override protected void OnDelete(IEntity owner)
+	protected void StopChain()
 	{
-		GetGame().GetCallqueue().Remove(Init);
 		GetGame().GetCallqueue().Remove(TrySpawnNext);
+		if (!m_bChainRunning)
+			return;
 
-		// Zero the spawner back-reference on all live nodes so they don't call
-		// OnNodeDied on a deleted spawner (dangling pointer).
-		foreach (IEntity nodeEnt : m_aLiveNodes)
+		m_bChainRunning = false;
+		FireStats.s_iScheduled--;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	override protected void OnDelete(IEntity owner)
+	{
+		GetGame().GetCallqueue().Remove(Init);
+		if (m_bInitPending)
 		{
-			if (!nodeEnt)
-				continue;
-			FireSpreadNode node = FireSpreadNode.Cast(nodeEnt.FindComponent(FireSpreadNode));
-			if (node)
-				node.m_OwnerSpawner = null;
+			m_bInitPending = false;
+			FireStats.s_iScheduled--;
 		}
+		StopChain();
+
+		// Cells keep burning after the spawner is gone; the manager just stops reporting to it.
+		Unregister();
 
 		m_aShapes.Clear();
-		m_aLiveNodes.Clear();
+		m_aSlotCell.Clear();
+		m_aSlotPrev.Clear();
+		m_aSlotNext.Clear();
+		m_iOldestSlot = -1;
+		m_iNewestSlot = -1;
+		m_iFreeSlot   = -1;
+		m_aPathPos.Clear();
+		m_aPathMaterial.Clear();
 		m_sDamagedTrees.Clear();
 	}
 }
@@ -0,0 +1,30 @@
+// FireStats.c
+//
+// Cheap counters the fire systems bump at their expensive call sites, read by FireBenchmark.
+// Plain static ints — incrementing them costs nothing measurable, so they stay on in every build.
+//   • traces         — TraceMove calls (surface snapping, grid probes, client occlusion rays)
+//   • entity spawns  — prefabs and particle effects spawned (damage areas, decals, emitters, lights)
+//   • scheduled      — fire CallLater entries currently in the call queue (repeating ticks, pending spawner inits)
+//   • tick times     — milliseconds spent inside the simulation tick (grid step included), the grid step
+//                      alone and the visual tick, from System.GetTickCount. Whole milliseconds per call,
+//                      so single ticks under 1 ms only show up as a sum over many ticks.
+
+class FireStats
+{
+	static int s_iTraces;
+	static int s_iEntitySpawns;
+	static int s_iScheduled;		// not reset — it is a level, not a running total
+	static int s_iSimulationMs;
+	static int s_iGridMs;
+	static int s_iVisualMs;
+
+	//------------------------------------------------------------------------------------------------
+	static void Reset()
+	{
+		s_iTraces = 0;
+		s_iEntitySpawns = 0;
+		s_iSimulationMs = 0;
+		s_iGridMs = 0;
+		s_iVisualMs = 0;
+	}
+}
@@ -0,0 +1,117 @@
+// FireVegetationQueue.c
+//
+// Time-sliced tree ignition shared by every FireSpreadSpawner.
+// Spawners find trees around each new fire node and queue them here instead of damaging them
+// inside the query callback. The queue fells at most m_iTreesPerFrame trees per frame, so a
+// fire front sweeping through a forest spreads the physics and destruction work over frames.
+// Whether a prefab is vegetation is decided once per EntityPrefabData and cached, so the prefab
+// path is only read and lowercased the first time a tree type is seen.
+//
+// Server only.
+
+class FireVegetationQueue
+{
+	protected static ref FireVegetationQueue s_Instance;
+
+	protected static ref map<EntityPrefabData, bool> s_mVegetationPrefabs = new map<EntityPrefabData, bool>();
+
+	protected ref FireQueue<IEntity, float> m_Queue = new FireQueue<IEntity, float>();	// tree, damage — oldest first
+	protected ref set<IEntity> m_sQueued = new set<IEntity>();	// trees waiting in the queue — a tree is queued once
+
+	protected int  m_iTreesPerFrame = 2;
+	protected bool m_bProcessing;
+
+	//------------------------------------------------------------------------------------------------
+	static FireVegetationQueue GetInstance()
+	{
+		if (!s_Instance)
+			s_Instance = new FireVegetationQueue();
+		return s_Instance;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// True if the entity's prefab lives under Prefabs/Vegetation. Cached per prefab.
+	static bool IsVegetationPrefab(IEntity ent)
+	{
+		EntityPrefabData pd = ent.GetPrefabData();
+		if (!pd)
+			return false;
+
+		bool isVegetation;
+		if (s_mVegetationPrefabs.Find(pd, isVegetation))
+			return isVegetation;
+
+		string pathLower = pd.GetPrefabName();
+		pathLower.ToLower();
+		isVegetation = pathLower.Contains("prefabs/vegetation");
+
+		s_mVegetationPrefabs.Insert(pd, isVegetation);
+		return isVegetation;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	void SetTreesPerFrame(int count)
+	{
+		m_iTreesPerFrame = Math.Max(count, 1);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	int GetQueuedCount()
+	{
+		return m_Queue.Count();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// Queues fire damage for a tree. Returns false if the tree is already waiting.
+	bool Enqueue(notnull BaseTree tree, float damage)
+	{
+		if (m_sQueued.Contains(tree))
+			return false;
+
+		m_sQueued.Insert(tree);
+		m_Queue.Push(tree, damage);
+
+		if (!m_bProcessing)
+		{
+			m_bProcessing = true;
+			FireStats.s_iScheduled++;
+			GetGame().GetCallqueue().CallLater(Process, 0, true);
+		}
+		return true;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void Process()
+	{
+		int felled;
+		while (!m_Queue.IsEmpty() && felled < m_iTreesPerFrame)
+		{
+			float damage = m_Queue.PeekValue();
+			IEntity ent = m_Queue.Pop();
+
+			// Deleted while waiting (streamed out, destroyed by something else) — costs nothing.
+			BaseTree tree = BaseTree.Cast(ent);
+			if (!tree)
+				continue;
+
+			m_sQueued.RemoveItem(tree);
+
+			// Trees only — use damage system so they fall over properly.
+			vector hitPosDirNorm[3];
+			hitPosDirNorm[0] = tree.GetOrigin();
+			hitPosDirNorm[1] = Vector(0, -1, 0);
+			hitPosDirNorm[2] = Vector(0, -1, 0);
+			tree.HandleDamage(EDamageType.FIRE, damage, hitPosDirNorm);
+			felled++;
+		}
+
+		if (m_Queue.IsEmpty())
+		{
+			m_Queue.Clear();
+			m_sQueued.Clear();
+			m_bProcessing = false;
+			FireStats.s_iScheduled--;
+			GetGame().GetCallqueue().Remove(Process);
+		}
+	}
+}
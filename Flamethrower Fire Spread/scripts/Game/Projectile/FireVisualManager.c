@@ -0,0 +1,426 @@
+// FireVisualManager.c
+//
+// Local visuals for fire cells on every machine that renders.
+// FireSpreadSpawner forwards each ignition here (on the server directly, on clients via broadcast).
+// Cells are kept in a struct-of-arrays pool with their own remaining lifetime. A single tick picks
+// a level of detail for each cell from its distance to the camera:
+//   • near  — the cell has its own particle;
+//   • mid   — cells share one emitter per cluster (m_fClusterSize grid), placed at their centre;
+//   • far   — beyond the visible distance, or when terrain hides the cluster, only an optional
+//             cheap light per cluster is shown, and nothing past the light distance.
+// Emitters are spawned once and replayed on their loop interval instead of being deleted and
+// respawned, so a burning field costs a handful of entities that live as long as the fire.
+
+class FireVisualManager
+{
+	protected static ref FireVisualManager s_Instance;
+
+	protected static const float TICK_INTERVAL     = 0.25;		// seconds between LOD / lifetime updates
+	protected static const float HIDE_DISTANCE_MUL = 1.1;		// hysteresis so cells on the edge don't flicker
+	protected static const float OCCLUSION_HEIGHT  = 1.5;		// metres above the cluster centre the occlusion ray aims at
+
+	// Visual pool — struct of arrays, all index-aligned. Removal moves the last cell into the hole.
+	protected ref array<int>    m_aCellId        = new array<int>();
+	protected ref array<vector> m_aCellPos       = new array<vector>();
+	protected ref array<float>  m_aCellRemaining = new array<float>();
+	protected ref array<int>    m_aCellTemplate  = new array<int>();
+	protected ref array<float>  m_aCellNextLoop  = new array<float>();
+	protected ref array<ParticleEffectEntity> m_aCellParticle = new array<ParticleEffectEntity>();	// near cells only
+	protected ref map<int, int> m_mCellIndex     = new map<int, int>();	// cell id -> pool index
+
+	// Clusters of cells beyond the near distance — same layout. Rebuilt from the cells every tick.
+	protected ref array<int>    m_aClusterKey      = new array<int>();
+	protected ref array<int>    m_aClusterTemplate = new array<int>();
+	protected ref array<vector> m_aClusterSum      = new array<vector>();	// sum of member positions this tick
+	protected ref array<int>    m_aClusterCount    = new array<int>();	// members this tick
+	protected ref array<float>  m_aClusterNextLoop = new array<float>();
+	protected ref array<ParticleEffectEntity> m_aClusterEmitter = new array<ParticleEffectEntity>();
+	protected ref array<IEntity> m_aClusterLight   = new array<IEntity>();
+	protected ref map<int, int> m_mClusterIndex    = new map<int, int>();	// cluster key -> index
+
+	protected bool m_bTicking;
+	protected ref TraceParam m_Trace = new TraceParam();
+
+	//------------------------------------------------------------------------------------------------
+	static FireVisualManager GetInstance()
+	{
+		if (!s_Instance)
+			s_Instance = new FireVisualManager();
+		return s_Instance;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	int GetCellCount()
+	{
+		return m_aCellId.Count();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	int GetClusterCount()
+	{
+		return m_aClusterKey.Count();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// Spawns the cell's decal and tracks it for particles. Machines without a renderer only get the decal.
+	// remaining <= 0 = a fresh cell with the template's whole lifetime ahead of it.
+	void AddCell(int cellId, vector pos, notnull FireCellTemplate tmpl, float remaining = -1)
+	{
+		if (m_mCellIndex.Contains(cellId))
+			return;
+
+		SpawnDecal(pos, tmpl);
+
+		if (System.IsConsoleApp() || tmpl.m_rParticleEffect.IsEmpty())
+			return;
+
+		int index = m_aCellId.Insert(cellId);
+		m_aCellPos.Insert(pos);
+		if (remaining <= 0)
+			remaining = tmpl.m_fTotalDuration;
+		m_aCellRemaining.Insert(remaining);
+		m_aCellTemplate.Insert(tmpl.m_iIndex);
+		m_aCellNextLoop.Insert(0);
+		m_aCellParticle.Insert(null);
+		m_mCellIndex.Insert(cellId, index);
+
+		// Show it right away if close — the next tick would be up to TICK_INTERVAL late.
+		// Cells further out join their cluster on the next tick.
+		UpdateNearCell(index, tmpl, GetCameraPos());
+
+		if (!m_bTicking)
+		{
+			m_bTicking = true;
+			FireStats.s_iScheduled++;
+			GetGame().GetCallqueue().CallLater(Tick, TICK_INTERVAL * 1000, true);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// Removes a cell before its lifetime ran out (evicted on the server).
+	void RemoveCell(int cellId)
+	{
+		int index;
+		if (m_mCellIndex.Find(cellId, index))
+			RemoveCellAt(index);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void Tick()
+	{
+		int tickStart = System.GetTickCount();
+		vector cameraPos = GetCameraPos();
+
+		for (int c = m_aClusterKey.Count() - 1; c >= 0; c--)
+		{
+			m_aClusterSum[c] = vector.Zero;
+			m_aClusterCount[c] = 0;
+		}
+
+		for (int i = m_aCellId.Count() - 1; i >= 0; i--)
+		{
+			float remaining = m_aCellRemaining[i] - TICK_INTERVAL;
+			FireCellTemplate tmpl = FireCellTemplate.GetByIndex(m_aCellTemplate[i]);
+			if (!tmpl || remaining <= 0)
+			{
+				RemoveCellAt(i);
+				continue;
+			}
+
+			m_aCellRemaining[i] = remaining;
+			if (UpdateNearCell(i, tmpl, cameraPos))
+				continue;
+
+			if (vector.DistanceSq(cameraPos, m_aCellPos[i]) <= tmpl.m_fLightDistance * tmpl.m_fLightDistance)
+				AddToCluster(m_aCellPos[i], tmpl);
+		}
+
+		for (int k = m_aClusterKey.Count() - 1; k >= 0; k--)
+		{
+			UpdateCluster(k, cameraPos);
+		}
+
+		if (m_aCellId.IsEmpty())
+		{
+			m_bTicking = false;
+			FireStats.s_iScheduled--;
+			GetGame().GetCallqueue().Remove(Tick);
+		}
+
+		FireStats.s_iVisualMs += System.GetTickCount() - tickStart;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// Gives a near cell its own particle and keeps it looping. Returns false when the cell is
+	// beyond the near distance (its particle, if any, is removed and the cell goes to a cluster).
+	protected bool UpdateNearCell(int index, FireCellTemplate tmpl, vector cameraPos)
+	{
+		float distSq = vector.DistanceSq(cameraPos, m_aCellPos[index]);
+		ParticleEffectEntity particle = m_aCellParticle[index];
+
+		float nearDist = tmpl.m_fNearDistance;
+		if (particle)
+			nearDist = nearDist * HIDE_DISTANCE_MUL;
+
+		if (distSq > nearDist * nearDist)
+		{
+			if (particle)
+			{
+				SCR_EntityHelper.DeleteEntityAndChildren(particle);
+				m_aCellParticle[index] = null;
+			}
+			return false;
+		}
+
+		if (!particle)
+		{
+			m_aCellParticle[index] = PlayParticle(m_aCellPos[index], tmpl.m_rParticleEffect);
+			m_aCellNextLoop[index] = tmpl.m_fParticleLoopInterval;
+			return true;
+		}
+
+		m_aCellNextLoop[index] = LoopParticle(particle, m_aCellNextLoop[index], tmpl);
+		return true;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void AddToCluster(vector pos, FireCellTemplate tmpl)
+	{
+		int cx = Math.Floor(pos[0] / tmpl.m_fClusterSize);
+		int cz = Math.Floor(pos[2] / tmpl.m_fClusterSize);
+		int key = MakeClusterKey(cx, cz, tmpl.m_iIndex);
+
+		int index;
+		if (!m_mClusterIndex.Find(key, index))
+		{
+			index = m_aClusterKey.Insert(key);
+			m_aClusterTemplate.Insert(tmpl.m_iIndex);
+			m_aClusterSum.Insert(vector.Zero);
+			m_aClusterCount.Insert(0);
+			m_aClusterNextLoop.Insert(0);
+			m_aClusterEmitter.Insert(null);
+			m_aClusterLight.Insert(null);
+			m_mClusterIndex.Insert(key, index);
+		}
+
+		m_aClusterSum[index] = m_aClusterSum[index] + pos;
+		m_aClusterCount[index] = m_aClusterCount[index] + 1;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// Shows a cluster as one shared emitter (mid range, in view) or a cheap light (far or hidden).
+	// Clusters that lost all their cells this tick are removed.
+	protected void UpdateCluster(int index, vector cameraPos)
+	{
+		int count = m_aClusterCount[index];
+		FireCellTemplate tmpl = FireCellTemplate.GetByIndex(m_aClusterTemplate[index]);
+		if (count == 0 || !tmpl)
+		{
+			RemoveClusterAt(index);
+			return;
+		}
+
+		vector center = m_aClusterSum[index] * (1.0 / count);
+		float distSq = vector.DistanceSq(cameraPos, center);
+		ParticleEffectEntity emitter = m_aClusterEmitter[index];
+
+		float visibleDist = tmpl.m_fVisibleDistance;
+		if (emitter)
+			visibleDist = visibleDist * HIDE_DISTANCE_MUL;
+
+		bool showEmitter = distSq <= visibleDist * visibleDist && !tmpl.m_rClusterParticle.IsEmpty() && !IsOccluded(cameraPos, center);
+		if (showEmitter)
+		{
+			DeleteClusterLight(index);
+
+			if (!emitter)
+			{
+				m_aClusterEmitter[index] = PlayParticle(center, tmpl.m_rClusterParticle);
+				m_aClusterNextLoop[index] = tmpl.m_fParticleLoopInterval;
+				return;
+			}
+
+			// Members come and go — keep the emitter over the cluster's current centre.
+			PlaceEntity(emitter, center);
+			m_aClusterNextLoop[index] = LoopParticle(emitter, m_aClusterNextLoop[index], tmpl);
+			return;
+		}
+
+		if (emitter)
+		{
+			SCR_EntityHelper.DeleteEntityAndChildren(emitter);
+			m_aClusterEmitter[index] = null;
+		}
+
+		// Cells past the light distance were never added, so every cluster here is within it.
+		IEntity light = m_aClusterLight[index];
+		if (light)
+		{
+			PlaceEntity(light, center);
+			return;
+		}
+
+		Resource lightRes = tmpl.GetFarLightResource();
+		if (lightRes)
+			m_aClusterLight[index] = SpawnAt(lightRes, center);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// Terrain between the camera and the cluster. Objects are ignored — they are too cheap to hide
+	// behind and the ray is cast per cluster every tick.
+	protected bool IsOccluded(vector cameraPos, vector center)
+	{
+		m_Trace.Start = cameraPos;
+		m_Trace.End   = center + Vector(0, OCCLUSION_HEIGHT, 0);
+		m_Trace.Flags = TraceFlags.WORLD;
+
+		FireStats.s_iTraces++;
+		return GetGame().GetWorld().TraceMove(m_Trace, null) < 1.0;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// Replays a spawned emitter once its effect has run out. Returns the time left until the next replay.
+	protected float LoopParticle(ParticleEffectEntity particle, float nextLoop, FireCellTemplate tmpl)
+	{
+		if (tmpl.m_fParticleLoopInterval <= 0)
+			return nextLoop;
+
+		nextLoop -= TICK_INTERVAL;
+		if (nextLoop > 0)
+			return nextLoop;
+
+		particle.Play();
+		return tmpl.m_fParticleLoopInterval;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected ParticleEffectEntity PlayParticle(vector pos, ResourceName effect)
+	{
+		ParticleEffectEntitySpawnParams ptcParams = new ParticleEffectEntitySpawnParams();
+		ptcParams.TransformMode     = ETransformMode.WORLD;
+		ptcParams.PlayOnSpawn       = true;
+		ptcParams.DeleteWhenStopped = false;	// kept and replayed by LoopParticle
+		Math3D.MatrixIdentity4(ptcParams.Transform);
+		ptcParams.Transform[3] = pos;
+
+		FireStats.s_iEntitySpawns++;
+		return ParticleEffectEntity.SpawnParticleEffect(effect, ptcParams);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void SpawnDecal(vector pos, FireCellTemplate tmpl)
+	{
+		Resource res = tmpl.GetDecalResource();
+		if (res)
+			SpawnAt(res, pos);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected IEntity SpawnAt(Resource res, vector pos)
+	{
+		vector transform[4];
+		Math3D.MatrixIdentity4(transform);
+		transform[3] = pos;
+
+		EntitySpawnParams params = new EntitySpawnParams();
+		params.TransformMode = ETransformMode.WORLD;
+		params.Transform     = transform;
+
+		FireStats.s_iEntitySpawns++;
+		return GetGame().SpawnEntityPrefab(res, GetGame().GetWorld(), params);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void PlaceEntity(IEntity ent, vector pos)
+	{
+		vector transform[4];
+		Math3D.MatrixIdentity4(transform);
+		transform[3] = pos;
+		ent.SetWorldTransform(transform);
+		ent.Update();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected vector GetCameraPos()
+	{
+		vector camMat[4];
+		GetGame().GetWorld().GetCurrentCamera(camMat);
+		return camMat[3];
+	}
+
+	//------------------------------------------------------------------------------------------------
+	// 10 bits per axis and for the template — clusters only need to be unique within the light distance.
+	protected int MakeClusterKey(int x, int z, int templateIndex)
+	{
+		return ((x & 0x3FF) << 20) | ((z & 0x3FF) << 10) | (templateIndex & 0x3FF);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void DeleteClusterLight(int index)
+	{
+		if (!m_aClusterLight[index])
+			return;
+
+		SCR_EntityHelper.DeleteEntityAndChildren(m_aClusterLight[index]);
+		m_aClusterLight[index] = null;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void RemoveClusterAt(int index)
+	{
+		if (m_aClusterEmitter[index])
+			SCR_EntityHelper.DeleteEntityAndChildren(m_aClusterEmitter[index]);
+		DeleteClusterLight(index);
+
+		int last = m_aClusterKey.Count() - 1;
+		m_mClusterIndex.Remove(m_aClusterKey[index]);
+
+		if (index != last)
+		{
+			m_aClusterKey[index]      = m_aClusterKey[last];
+			m_aClusterTemplate[index] = m_aClusterTemplate[last];
+			m_aClusterSum[index]      = m_aClusterSum[last];
+			m_aClusterCount[index]    = m_aClusterCount[last];
+			m_aClusterNextLoop[index] = m_aClusterNextLoop[last];
+			m_aClusterEmitter[index]  = m_aClusterEmitter[last];
+			m_aClusterLight[index]    = m_aClusterLight[last];
+			m_mClusterIndex.Set(m_aClusterKey[index], index);
+		}
+
+		m_aClusterKey.Remove(last);
+		m_aClusterTemplate.Remove(last);
+		m_aClusterSum.Remove(last);
+		m_aClusterCount.Remove(last);
+		m_aClusterNextLoop.Remove(last);
+		m_aClusterEmitter.Remove(last);
+		m_aClusterLight.Remove(last);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void RemoveCellAt(int index)
+	{
+		if (m_aCellParticle[index])
+			SCR_EntityHelper.DeleteEntityAndChildren(m_aCellParticle[index]);
+
+		int last = m_aCellId.Count() - 1;
+		m_mCellIndex.Remove(m_aCellId[index]);
+
+		if (index != last)
+		{
+			m_aCellId[index]        = m_aCellId[last];
+			m_aCellPos[index]       = m_aCellPos[last];
+			m_aCellRemaining[index] = m_aCellRemaining[last];
+			m_aCellTemplate[index]  = m_aCellTemplate[last];
+			m_aCellNextLoop[index]  = m_aCellNextLoop[last];
+			m_aCellParticle[index]  = m_aCellParticle[last];
+			m_mCellIndex.Set(m_aCellId[index], index);
+		}
+
+		m_aCellId.Remove(last);
+		m_aCellPos.Remove(last);
+		m_aCellRemaining.Remove(last);
+		m_aCellTemplate.Remove(last);
+		m_aCellNextLoop.Remove(last);
+		m_aCellParticle.Remove(last);
+	}
+}
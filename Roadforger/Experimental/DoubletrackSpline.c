@@ -85,6 +85,22 @@ class SCR_RoadTrackConfig : Managed
 	
 	[Attribute("", UIWidgets.EditBox, "Description for UI")]
 	string m_sDescription;
+	
+	protected ref Resource m_RoadResource;
+	protected bool m_bRoadResolved;
+	
+	//------------------------------------------------------------------------------------------------
+	// Loaded once through SCR_PrefabResourceCache - null if the prefab failed to load
+	Resource GetRoadResource()
+	{
+		if (!m_bRoadResolved)
+		{
+			m_RoadResource = SCR_PrefabResourceCache.Load(m_sRoadPrefab, "SCR_RoadTrackConfig '" + m_sConfigName + "'");
+			m_bRoadResolved = true;
+		}
+		
+		return m_RoadResource;
+	}
 }
 
 //------------------------------------------------------------------------------------------------
@@ -114,6 +130,22 @@ class SCR_PrefabTrackConfig : Managed
 	
 	[Attribute("0", UIWidgets.CheckBox, "Ignore fuel requirement for prefabs")]
 	bool m_bIgnoreFuelRequirement;
+	
+	protected ref Resource m_DeformationResource;
+	protected bool m_bDeformationResolved;
+	
+	//------------------------------------------------------------------------------------------------
+	// Loaded once through SCR_PrefabResourceCache - null if the prefab failed to load
+	Resource GetDeformationResource()
+	{
+		if (!m_bDeformationResolved)
+		{
+			m_DeformationResource = SCR_PrefabResourceCache.Load(m_sDeformationPrefab, "SCR_PrefabTrackConfig");
+			m_bDeformationResolved = true;
+		}
+		
+		return m_DeformationResource;
+	}
 }
 
 //------------------------------------------------------------------------------------------------
@@ -241,12 +273,39 @@ class SCR_VehicleSplineTrackSpawnerComponent : ScriptComponent
 		m_bConstructionMode = false;
 		m_iSelectedConstructionConfigIndex = 0;
 		
+		WarmPrefabResources();
 		SetEventMask(owner, EntityEvent.FRAME);
 		
 		if (m_bDebug)
 			Print("VehicleSplineTrackSpawner initialized", LogLevel.NORMAL);
 	}
 	
+	//------------------------------------------------------------------------------------------------
+	// Loads every enabled road and deformation prefab now, so failures show at startup, not on first spawn
+	protected void WarmPrefabResources()
+	{
+		if (m_aRoadConfigs)
+		{
+			foreach (SCR_RoadTrackConfig config : m_aRoadConfigs)
+			{
+				if (config && config.m_bEnabled)
+					config.GetRoadResource();
+			}
+		}
+		
+		if (m_aConstructionRoadConfigs)
+		{
+			foreach (SCR_RoadTrackConfig config : m_aConstructionRoadConfigs)
+			{
+				if (config && config.m_bEnabled)
+					config.GetRoadResource();
+			}
+		}
+		
+		if (m_PrefabConfig && m_PrefabConfig.m_bEnabled)
+			m_PrefabConfig.GetDeformationResource();
+	}
+	
 	//------------------------------------------------------------------------------------------------
 	override void EOnFrame(IEntity owner, float timeSlice)
 	{
@@ -918,8 +977,8 @@ class SCR_VehicleSplineTrackSpawnerComponent : ScriptComponent
 		if (!m_PrefabConfig || !m_PrefabConfig.m_bEnabled || m_PrefabConfig.m_sDeformationPrefab == "")
 			return;
 		
-		Resource prefabResource = Resource.Load(m_PrefabConfig.m_sDeformationPrefab);
-		if (!prefabResource || !prefabResource.IsValid())
+		Resource prefabResource = m_PrefabConfig.GetDeformationResource();
+		if (!prefabResource)
 			return;
 		
 		float totalLength = CalculatePathLength(splinePoints);
@@ -1023,8 +1082,8 @@ class SCR_VehicleSplineTrackSpawnerComponent : ScriptComponent
 		if (!roadConfig || !roadConfig.m_bEnabled)
 			return null;
 		
-		Resource roadResource = Resource.Load(roadConfig.m_sRoadPrefab);
-		if (!roadResource || !roadResource.IsValid())
+		Resource roadResource = roadConfig.GetRoadResource();
+		if (!roadResource)
 			return null;
 		
 		vector splineTransform[4];
@@ -0,0 +1,32 @@
+//------------------------------------------------------------------------------------------------
+//! Prefab Resource Cache
+//! Shared Resource.Load cache for the Roadforger spawners
+//! Each prefab is loaded once per session. A prefab that fails to load is reported once and
+//! remembered as null, so spawners skip it without retrying the load on every spawn
+//------------------------------------------------------------------------------------------------
+class SCR_PrefabResourceCache
+{
+	protected static ref map<ResourceName, ref Resource> s_mResources = new map<ResourceName, ref Resource>();
+	
+	//------------------------------------------------------------------------------------------------
+	//! Loaded resource of the prefab, null if it is empty or failed to load
+	static Resource Load(ResourceName prefab, string context)
+	{
+		if (prefab.IsEmpty())
+			return null;
+		
+		Resource res;
+		if (s_mResources.Find(prefab, res))
+			return res;
+		
+		res = Resource.Load(prefab);
+		if (!res || !res.IsValid())
+		{
+			Print(string.Format("%1: Failed to load prefab %2 - it will not be spawned", context, prefab), LogLevel.ERROR);
+			res = null;
+		}
+		
+		s_mResources.Insert(prefab, res);
+		return res;
+	}
+}
@@ -50,12 +50,50 @@ class SCR_TrackPrefabConfig
 	
 	float m_fCachedTrackLength = 0;
 	
+	protected ref Resource m_PrefabResource;
+	protected bool m_bPrefabResolved;
+	protected string m_sCachedTerrainType;
+	protected bool m_bTerrainTypeResolved;
+	
+	//------------------------------------------------------------------------------------------------
+	//! Loaded once through SCR_PrefabResourceCache - null if the prefab failed to load
+	Resource GetPrefabResource()
+	{
+		if (!m_bPrefabResolved)
+		{
+			m_PrefabResource = SCR_PrefabResourceCache.Load(m_sPrefabResource, "SCR_TrackPrefabConfig '" + m_sConfigName + "'");
+			m_bPrefabResolved = true;
+		}
+		
+		return m_PrefabResource;
+	}
+	
 	//------------------------------------------------------------------------------------------------
 	void SetCachedTrackLength(float length)
 	{
 		m_fCachedTrackLength = length;
 	}
 	
+	//------------------------------------------------------------------------------------------------
+	//! Terrain type of the prefab's collision marker - empty while unknown or if it has none
+	string GetCachedTerrainType()
+	{
+		return m_sCachedTerrainType;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	bool IsTerrainTypeResolved()
+	{
+		return m_bTerrainTypeResolved;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	void SetCachedTerrainType(string terrainType)
+	{
+		m_sCachedTerrainType = terrainType;
+		m_bTerrainTypeResolved = true;
+	}
+	
 	//------------------------------------------------------------------------------------------------
 	float GetTrackLength()
 	{
@@ -193,16 +231,37 @@ class SCR_SingleTrackSpawnerComponent : ScriptComponent
 	[Attribute("0", UIWidgets.CheckBox, "Enable debug", category: "General")]
 	protected bool m_bDebug;
 	
+	[Attribute("0", UIWidgets.CheckBox, "Draw tracks as continuous decal strips instead of segment prefabs (local visual, not on dedicated servers)", category: "Ribbon")]
+	protected bool m_bRibbonMode;
+	
+	[Attribute("", UIWidgets.ResourcePickerThumbnail, "Track decal material", "emat", category: "Ribbon")]
+	protected ResourceName m_sRibbonMaterial;
+	
+	[Attribute("0.3", UIWidgets.Slider, "Strip width (m)", "0.05 2.0 0.05", category: "Ribbon")]
+	protected float m_fRibbonWidth;
+	
+	[Attribute("120", UIWidgets.Slider, "Strip lifetime (seconds)", "5 600 5", category: "Ribbon")]
+	protected float m_fRibbonLifetime;
+	
+	[Attribute("0.5", UIWidgets.Slider, "Point spacing (m)", "0.1 5.0 0.1", category: "Ribbon")]
+	protected float m_fRibbonPointSpacing;
+	
+	[Attribute("32", UIWidgets.Slider, "Points per decal chunk", "4 256 1", category: "Ribbon")]
+	protected int m_iRibbonChunkPoints;
+	
+	[Attribute("512", UIWidgets.Slider, "Max points per wheel", "32 4096 32", category: "Ribbon")]
+	protected int m_iRibbonMaxPoints;
+	
 	protected Vehicle m_Vehicle;
 	protected VehicleWheeledSimulation m_Simulation;
 	protected vector m_vLastFrontLeftSpawn;
 	protected vector m_vLastFrontRightSpawn;
 	protected vector m_vLastRearLeftSpawn;
 	protected vector m_vLastRearRightSpawn;
-	protected ref array<IEntity> m_aSpawnedTracks;
-	protected ref map<IEntity, float> m_mTrackSpawnTimes;
-	protected ref map<IEntity, vector> m_mTrackCenters;
-	protected ref map<IEntity, bool> m_mTrackIsLeft;
+	
+	//! Spawned tracks in spawn order, evicted from the front
+	protected ref SCR_SpawnedTrackQueue m_SpawnedTracks;
+	
 	protected ref array<string> m_aBlockedTerrainList;
 	protected SCR_VehicleTerrainDetectorComponent m_TerrainDetector;
 	
@@ -235,13 +294,25 @@ class SCR_SingleTrackSpawnerComponent : ScriptComponent
 	protected SCR_TrackPrefabConfig m_LastSpawnedRearDualPrefab;
 	protected bool m_bLastFrontDualContact;
 	protected bool m_bLastRearDualContact;
+	
+	//! Ribbon mode - front left, front right, rear left, rear right
+	protected ref array<ref SCR_TrackRibbon> m_aRibbons;
+	protected ref TraceParam m_RibbonTrace;
 	//------------------------------------------------------------------------------------------------
 	override void OnPostInit(IEntity owner)
 	{
 		super.OnPostInit(owner);
 		
-		if (!Replication.IsServer())
+		if (m_bRibbonMode)
+		{
+			//! Decals are drawn locally by every machine that renders - a dedicated server has none
+			if (RplSession.Mode() == RplMode.Dedicated)
+				return;
+		}
+		else if (!Replication.IsServer())
+		{
 			return;
+		}
 		
 		m_Vehicle = Vehicle.Cast(owner);
 		if (!m_Vehicle)
@@ -253,10 +324,7 @@ class SCR_SingleTrackSpawnerComponent : ScriptComponent
 		
 		m_TerrainDetector = SCR_VehicleTerrainDetectorComponent.Cast(m_Vehicle.FindComponent(SCR_VehicleTerrainDetectorComponent));
 		
-		m_aSpawnedTracks = new array<IEntity>();
-		m_mTrackSpawnTimes = new map<IEntity, float>();
-		m_mTrackCenters = new map<IEntity, vector>();
-		m_mTrackIsLeft = new map<IEntity, bool>();
+		m_SpawnedTracks = new SCR_SpawnedTrackQueue();
 		m_vLastFrontLeftSpawn = vector.Zero;
 		m_vLastFrontRightSpawn = vector.Zero;
 		m_vLastRearLeftSpawn = vector.Zero;
@@ -283,13 +351,86 @@ class SCR_SingleTrackSpawnerComponent : ScriptComponent
 		m_bLastFrontDualContact = false;
 		m_bLastRearDualContact = false;
 		
+		//! Enough parked segments per prefab to refill one vehicle's trail without spawning
+		SCR_TrackEntityPool.GetInstance().EnsureCapacity(Math.Min(m_iMaxTracksPerVehicle, s_iGlobalMaxTracks));
+		
 		ParseBlockedTerrains();
+		
+		if (m_bRibbonMode)
+		{
+			if (!InitRibbons())
+				return;
+		}
+		else
+		{
+			WarmPrefabResources();
+		}
+		
 		SetEventMask(owner, EntityEvent.FRAME);
 		
 		if (m_bDebug)
 			Print("=== Track Spawner Initialized ===", LogLevel.NORMAL);
 	}
 	
+	//------------------------------------------------------------------------------------------------
+	//! Loads every enabled track prefab now, so failures are reported at startup and not on first spawn
+	protected void WarmPrefabResources()
+	{
+		if (m_FrontDriveConfig)
+		{
+			if (m_FrontDriveConfig.m_DualTrack)
+				WarmPrefabs(m_FrontDriveConfig.m_DualTrack.m_aPrefabs);
+			if (m_FrontDriveConfig.m_LeftTrack)
+				WarmPrefabs(m_FrontDriveConfig.m_LeftTrack.m_aPrefabs);
+			if (m_FrontDriveConfig.m_RightTrack)
+				WarmPrefabs(m_FrontDriveConfig.m_RightTrack.m_aPrefabs);
+		}
+		
+		if (m_ReverseDriveConfig)
+		{
+			if (m_ReverseDriveConfig.m_DualTrack)
+				WarmPrefabs(m_ReverseDriveConfig.m_DualTrack.m_aPrefabs);
+			if (m_ReverseDriveConfig.m_LeftTrack)
+				WarmPrefabs(m_ReverseDriveConfig.m_LeftTrack.m_aPrefabs);
+			if (m_ReverseDriveConfig.m_RightTrack)
+				WarmPrefabs(m_ReverseDriveConfig.m_RightTrack.m_aPrefabs);
+		}
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	protected void WarmPrefabs(array<ref SCR_TrackPrefabConfig> prefabs)
+	{
+		if (!prefabs)
+			return;
+		
+		foreach (SCR_TrackPrefabConfig prefab : prefabs)
+		{
+			if (prefab && prefab.m_bEnabled)
+				prefab.GetPrefabResource();
+		}
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	protected bool InitRibbons()
+	{
+		if (m_sRibbonMaterial == "")
+		{
+			Print("SCR_SingleTrackSpawner: Ribbon mode needs a track decal material!", LogLevel.ERROR);
+			return false;
+		}
+		
+		m_aRibbons = new array<ref SCR_TrackRibbon>();
+		for (int i = 0; i < 4; i++)
+		{
+			m_aRibbons.Insert(new SCR_TrackRibbon(m_sRibbonMaterial, m_fRibbonWidth, m_fRibbonLifetime, m_iRibbonChunkPoints, m_iRibbonMaxPoints));
+		}
+		
+		m_RibbonTrace = new TraceParam();
+		m_RibbonTrace.Flags = TraceFlags.WORLD | TraceFlags.ENTS;
+		m_RibbonTrace.Exclude = m_Vehicle;
+		return true;
+	}
+	
 	//------------------------------------------------------------------------------------------------
 	void ParseBlockedTerrains()
 	{
@@ -341,12 +482,18 @@ class SCR_SingleTrackSpawnerComponent : ScriptComponent
 		if (!m_bEnabled || !m_Vehicle || !m_Simulation)
 			return;
 		
+		if (m_bRibbonMode)
+		{
+			ProcessRibbons();
+			return;
+		}
+		
 		if (!m_bIgnoreLimits)
 		{
 			if (s_iTotalTracksSpawned >= s_iGlobalMaxTracks)
 				CleanupOldestTrack();
 			
-			if (m_aSpawnedTracks.Count() >= m_iMaxTracksPerVehicle)
+			if (GetSpawnedTrackCount() >= m_iMaxTracksPerVehicle)
 				CleanupOldestTrack();
 		}
 		
@@ -442,6 +589,105 @@ class SCR_SingleTrackSpawnerComponent : ScriptComponent
 		}
 	}
 	
+	//------------------------------------------------------------------------------------------------
+	//! Ribbon mode - each wheel in use extends its own strip, the pair not in use is ended
+	protected void ProcessRibbons()
+	{
+		bool reversing = IsReversing();
+		if (reversing != m_bWasReversing)
+		{
+			if (reversing)
+			{
+				m_aRibbons[0].Break();
+				m_aRibbons[1].Break();
+			}
+			else
+			{
+				m_aRibbons[2].Break();
+				m_aRibbons[3].Break();
+			}
+			m_bWasReversing = reversing;
+		}
+		
+		World world = GetGame().GetWorld();
+		float currentTime = world.GetWorldTime();
+		
+		if (reversing)
+		{
+			if (!m_ReverseDriveConfig || !m_ReverseDriveConfig.m_bEnabled)
+				return;
+			
+			ProcessRibbonWheel(m_aRibbons[2], GetRibbonWheel(m_ReverseDriveConfig.m_DualTrack, m_ReverseDriveConfig.m_LeftTrack, true), world, currentTime);
+			ProcessRibbonWheel(m_aRibbons[3], GetRibbonWheel(m_ReverseDriveConfig.m_DualTrack, m_ReverseDriveConfig.m_RightTrack, false), world, currentTime);
+		}
+		else
+		{
+			if (!m_FrontDriveConfig || !m_FrontDriveConfig.m_bEnabled)
+				return;
+			
+			ProcessRibbonWheel(m_aRibbons[0], GetRibbonWheel(m_FrontDriveConfig.m_DualTrack, m_FrontDriveConfig.m_LeftTrack, true), world, currentTime);
+			ProcessRibbonWheel(m_aRibbons[1], GetRibbonWheel(m_FrontDriveConfig.m_DualTrack, m_FrontDriveConfig.m_RightTrack, false), world, currentTime);
+		}
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Wheel index for one side of a drive config, -1 if that side draws nothing
+	protected int GetRibbonWheel(SCR_DualTrackConfig dual, SCR_TrackSideConfig side, bool isLeft)
+	{
+		if (dual && dual.m_bEnabled)
+		{
+			if (isLeft)
+				return dual.m_iLeftWheelIndex;
+			else
+				return dual.m_iRightWheelIndex;
+		}
+		
+		if (side)
+			return side.m_iWheelIndex;
+		
+		return -1;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	protected void ProcessRibbonWheel(SCR_TrackRibbon ribbon, int wheelIndex, World world, float currentTime)
+	{
+		if (wheelIndex < 0 || !m_Simulation.WheelHasContact(wheelIndex))
+		{
+			ribbon.Break();
+			return;
+		}
+		
+		vector contactPos = m_Simulation.WheelGetContactPosition(wheelIndex);
+		if (ribbon.HasLastPoint())
+		{
+			float spacingSq = m_fRibbonPointSpacing * m_fRibbonPointSpacing;
+			if (vector.DistanceSq(contactPos, ribbon.GetLastPoint()) < spacingSq)
+				return;
+		}
+		
+		m_RibbonTrace.Start = contactPos + Vector(0, 2, 0);
+		m_RibbonTrace.End = contactPos - Vector(0, 2, 0);
+		
+		float traceDist = world.TraceMove(m_RibbonTrace, null);
+		if (traceDist >= 1.0 || !m_RibbonTrace.TraceEnt)
+		{
+			ribbon.Break();
+			return;
+		}
+		
+		if (m_bEnableTerrainFilter && m_TerrainDetector && m_RibbonTrace.SurfaceProps)
+		{
+			string terrain = m_TerrainDetector.ClassifyMaterial(m_RibbonTrace.SurfaceProps.GetName(), false);
+			if (IsTerrainBlocked(terrain))
+			{
+				ribbon.Break();
+				return;
+			}
+		}
+		
+		ribbon.AddPoint(world, m_RibbonTrace.TraceEnt, contactPos, m_RibbonTrace.TraceNorm, currentTime);
+	}
+	
 	//------------------------------------------------------------------------------------------------
 //------------------------------------------------------------------------------------------------
 //------------------------------------------------------------------------------------------------
@@ -598,7 +844,6 @@ class SCR_SingleTrackSpawnerComponent : ScriptComponent
 		
 		if (spawnedTrack)
 		{
-			m_mTrackCenters.Set(spawnedTrack, spawnPos);
 			lastSpawnPos = spawnPos;
 			SetLastSpawnedPrefab(isRear, isLeft, activePrefab);
 			
@@ -643,51 +888,9 @@ class SCR_SingleTrackSpawnerComponent : ScriptComponent
 		vector rightWheelPos = m_Simulation.WheelGetContactPosition(config.m_iRightWheelIndex);
 		vector centerPos = (leftWheelPos + rightWheelPos) * 0.5;
 		
-		vector vehicleTransform[4];
-		m_Vehicle.GetWorldTransform(vehicleTransform);
-		vector vehicleDirection = vehicleTransform[2];
-		
-		IEntity foundLeftMarker;
-		IEntity foundRightMarker;
-		bool isAlignedLeft;
-		bool isAlignedRight;
-		
-		string leftMarker = SCR_SimpleCollisionMarkerComponent.CheckPositionAgainstAllMarkersWithEntity(
-			leftWheelPos, 0.5, foundLeftMarker, isAlignedLeft, vehicleDirection, m_fAlignmentThreshold
-		);
-		
-		string rightMarker = SCR_SimpleCollisionMarkerComponent.CheckPositionAgainstAllMarkersWithEntity(
-			rightWheelPos, 0.5, foundRightMarker, isAlignedRight, vehicleDirection, m_fAlignmentThreshold
-		);
-		
-		bool leftHasOldMarker = false;
-		bool rightHasOldMarker = false;
-		
-		if (leftMarker != "" && foundLeftMarker)
-		{
-			SCR_SimpleCollisionMarkerComponent leftMarkerComp = SCR_SimpleCollisionMarkerComponent.Cast(
-				foundLeftMarker.FindComponent(SCR_SimpleCollisionMarkerComponent)
-			);
-			if (leftMarkerComp)
-			{
-				float leftAge = leftMarkerComp.GetAge();
-				if (leftAge > m_fMinTrackAge)
-					leftHasOldMarker = true;
-			}
-		}
-		
-		if (rightMarker != "" && foundRightMarker)
-		{
-			SCR_SimpleCollisionMarkerComponent rightMarkerComp = SCR_SimpleCollisionMarkerComponent.Cast(
-				foundRightMarker.FindComponent(SCR_SimpleCollisionMarkerComponent)
-			);
-			if (rightMarkerComp)
-			{
-				float rightAge = rightMarkerComp.GetAge();
-				if (rightAge > m_fMinTrackAge)
-					rightHasOldMarker = true;
-			}
-		}
+		SCR_TrackMarkerGrid grid = SCR_TrackMarkerGrid.GetInstance();
+		bool leftHasOldMarker = grid.FindTrack(leftWheelPos, 0.5, m_fMinTrackAge) != null;
+		bool rightHasOldMarker = grid.FindTrack(rightWheelPos, 0.5, m_fMinTrackAge) != null;
 		
 		if (leftHasOldMarker || rightHasOldMarker)
 		{
@@ -761,7 +964,6 @@ class SCR_SingleTrackSpawnerComponent : ScriptComponent
 		
 		if (spawnedTrack)
 		{
-			m_mTrackCenters.Set(spawnedTrack, spawnPos);
 			lastSpawnPos = spawnPos;
 			
 			if (isRear)
@@ -914,55 +1116,14 @@ class SCR_SingleTrackSpawnerComponent : ScriptComponent
 	//------------------------------------------------------------------------------------------------
 	bool IsTrackNearby(vector position, float radius, bool isLeft)
 	{
-		foreach (IEntity track, vector center : m_mTrackCenters)
-		{
-			if (!track)
-				continue;
-			
-			if (m_mTrackIsLeft.Contains(track) && m_mTrackIsLeft.Get(track) != isLeft)
-				continue;
-			
-			float dist = vector.Distance(position, center);
-			if (dist < radius)
-				return true;
-		}
-		
-		return false;
+		return SCR_TrackMarkerGrid.GetInstance().HasTrackNearby(position, radius, m_Vehicle, isLeft);
 	}
 	
 	//------------------------------------------------------------------------------------------------
 	bool ShouldSkipDueToAlignment(vector position, vector direction)
 	{
-		vector flatDir = direction;
-		flatDir[1] = 0;
-		flatDir.Normalize();
-		
-		IEntity foundMarker;
-		bool isAligned;
-		SCR_SimpleCollisionMarkerComponent.CheckPositionAgainstAllMarkersWithEntity(
-			position,
-			0.3,
-			foundMarker,
-			isAligned,
-			flatDir,
-			m_fAlignmentThreshold
-		);
-		
-		if (foundMarker && isAligned)
-		{
-			SCR_SimpleCollisionMarkerComponent markerComp = SCR_SimpleCollisionMarkerComponent.Cast(
-				foundMarker.FindComponent(SCR_SimpleCollisionMarkerComponent)
-			);
-			
-			if (markerComp)
-			{
-				float age = markerComp.GetAge();
-				if (age > m_fMinTrackAge)
-					return true;
-			}
-		}
-		
-		return false;
+		IEntity foundMarker = SCR_TrackMarkerGrid.GetInstance().FindTrack(position, 0.3, m_fMinTrackAge, direction, m_fAlignmentThreshold);
+		return foundMarker != null;
 	}
 	
 	//------------------------------------------------------------------------------------------------
@@ -971,15 +1132,14 @@ class SCR_SingleTrackSpawnerComponent : ScriptComponent
 		if (!config || config.m_sPrefabResource == "")
 			return null;
 		
-		Resource res = Resource.Load(config.m_sPrefabResource);
-		if (!res || !res.IsValid())
+		Resource res = config.GetPrefabResource();
+		if (!res)
 			return null;
 		
 		vector vehicleMat[4];
 		m_Vehicle.GetWorldTransform(vehicleMat);
 		
-		EntitySpawnParams params = new EntitySpawnParams();
-		params.TransformMode = ETransformMode.WORLD;
+		vector trackMat[4];
 		
 		vector forward = direction;
 		forward[1] = 0;
@@ -1006,44 +1166,71 @@ class SCR_SingleTrackSpawnerComponent : ScriptComponent
 			up.Normalize();
 		}
 		
-		params.Transform[0] = right;
-		params.Transform[1] = up;
-		params.Transform[2] = forward;
+		trackMat[0] = right;
+		trackMat[1] = up;
+		trackMat[2] = forward;
 		
 		vector spawnPos = position + 
 			vehicleMat[0] * offset[0] + 
 			vehicleMat[1] * offset[1] + 
 			vehicleMat[2] * offset[2];
-		params.Transform[3] = spawnPos;
+		trackMat[3] = spawnPos;
 		
-		IEntity entity = GetGame().SpawnEntityPrefab(res, GetGame().GetWorld(), params);
+		IEntity entity = SCR_TrackEntityPool.GetInstance().Acquire(config.m_sPrefabResource, res, trackMat);
 		
 		if (entity)
 		{
-			m_aSpawnedTracks.Insert(entity);
 			s_iTotalTracksSpawned++;
 			
 			float currentTime = GetGame().GetWorld().GetWorldTime();
-			m_mTrackSpawnTimes.Set(entity, currentTime);
-			m_mTrackIsLeft.Set(entity, isLeft);
 			
-			if (config.m_fCachedTrackLength == 0)
+			if (config.m_fCachedTrackLength == 0 || !config.IsTerrainTypeResolved())
 			{
 				SCR_SimpleCollisionMarkerComponent marker = SCR_SimpleCollisionMarkerComponent.Cast(
 					entity.FindComponent(SCR_SimpleCollisionMarkerComponent)
 				);
 				
-				if (marker)
+				if (marker && config.m_fCachedTrackLength == 0)
 				{
 					float trackLength = marker.GetTrackLength();
 					config.SetCachedTrackLength(trackLength);
 				}
+				
+				if (!marker)
+					config.SetCachedTerrainType("");
+				else if (!config.IsTerrainTypeResolved())
+					LearnTerrainType(config, entity, spawnPos, forward);
 			}
+			
+			int gridId = SCR_TrackMarkerGrid.GetInstance().Insert(entity, m_Vehicle, spawnPos, forward, config.GetTrackLength() * 0.5, isLeft, currentTime, config.GetCachedTerrainType());
+			
+			m_SpawnedTracks.Push(entity, gridId, config.m_sPrefabResource);
 		}
 		
 		return entity;
 	}
 	
+	//------------------------------------------------------------------------------------------------
+	//! The marker component only reports a terrain type through its full scan, so the prefab's type
+	//! is read once from the first segment the scan finds as itself and then stored in the grid
+	//! with every segment. A scan that finds an overlapping neighbour instead is retried next spawn
+	protected void LearnTerrainType(SCR_TrackPrefabConfig config, IEntity entity, vector spawnPos, vector forward)
+	{
+		IEntity found;
+		bool isAligned;
+		string terrainType = SCR_SimpleCollisionMarkerComponent.CheckPositionAgainstAllMarkersWithEntity(
+			spawnPos, 
+			0.1, 
+			found, 
+			isAligned, 
+			forward,
+			0
+		);
+		
+		if (found == entity && terrainType != "")
+			config.SetCachedTerrainType(terrainType);
+	}
+	
 	//------------------------------------------------------------------------------------------------
 	vector GetTerrainNormal(vector position)
 	{
@@ -1159,87 +1346,54 @@ class SCR_SingleTrackSpawnerComponent : ScriptComponent
 	
 	//------------------------------------------------------------------------------------------------
 //------------------------------------------------------------------------------------------------
+	//! Evicts the oldest track - tracks are stored in spawn order, so it is always the front record
 	void CleanupOldestTrack()
 	{
-		if (!m_aSpawnedTracks || m_aSpawnedTracks.Count() == 0)
+		if (!m_SpawnedTracks)
 			return;
 		
-		float currentTime = GetGame().GetWorld().GetWorldTime();
-		IEntity oldestTrack;
-		float oldestAge = 0;
-		int oldestIndex = -1;
-		
-		for (int i = m_aSpawnedTracks.Count() - 1; i >= 0; i--)
+		while (!m_SpawnedTracks.IsEmpty())
 		{
-			IEntity track = m_aSpawnedTracks[i];
+			ResourceName prefab;
+			IEntity track = PopOldestTrack(prefab);
 			
+			//! Already deleted by someone else (decal removal) - drop the record and keep looking
 			if (!track)
-			{
-				m_aSpawnedTracks.Remove(i);
 				continue;
-			}
-			
-			if (!m_mTrackSpawnTimes.Contains(track))
-			{
-				m_aSpawnedTracks.Remove(i);
-				SCR_EntityHelper.DeleteEntityAndChildren(track);
-				continue;
-			}
 			
-			float spawnTime = m_mTrackSpawnTimes.Get(track);
-			float age = currentTime - spawnTime;
-			
-			if (age > oldestAge)
-			{
-				oldestAge = age;
-				oldestTrack = track;
-				oldestIndex = i;
-			}
+			SCR_TrackEntityPool.GetInstance().Release(prefab, track);
+			break;
 		}
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Drops the front record from the grid and the global count and returns its entity
+	protected IEntity PopOldestTrack(out ResourceName prefab)
+	{
+		int gridId;
+		IEntity track = m_SpawnedTracks.Pop(gridId, prefab);
+		SCR_TrackMarkerGrid.GetInstance().Remove(gridId);
+		s_iTotalTracksSpawned--;
 		
-		if (oldestTrack && oldestIndex >= 0)
-		{
-			m_aSpawnedTracks.Remove(oldestIndex);
-			m_mTrackSpawnTimes.Remove(oldestTrack);
-			m_mTrackCenters.Remove(oldestTrack);
-			m_mTrackIsLeft.Remove(oldestTrack);
-			
-			SCR_EntityHelper.DeleteEntityAndChildren(oldestTrack);
-			s_iTotalTracksSpawned--;
-		}
+		return track;
 	}
 	
 	//------------------------------------------------------------------------------------------------
 //------------------------------------------------------------------------------------------------
 	override void OnDelete(IEntity owner)
 	{
-		if (m_aSpawnedTracks)
+		if (m_SpawnedTracks)
 		{
-			foreach (IEntity track : m_aSpawnedTracks)
+			SCR_TrackEntityPool pool = SCR_TrackEntityPool.GetInstance();
+			while (!m_SpawnedTracks.IsEmpty())
 			{
+				ResourceName prefab;
+				IEntity track = PopOldestTrack(prefab);
 				if (track)
-					SCR_EntityHelper.DeleteEntityAndChildren(track);
+					pool.Release(prefab, track);
 			}
-			m_aSpawnedTracks.Clear();
-			m_aSpawnedTracks = null;
-		}
-		
-		if (m_mTrackSpawnTimes)
-		{
-			m_mTrackSpawnTimes.Clear();
-			m_mTrackSpawnTimes = null;
-		}
-		
-		if (m_mTrackCenters)
-		{
-			m_mTrackCenters.Clear();
-			m_mTrackCenters = null;
-		}
-		
-		if (m_mTrackIsLeft)
-		{
-			m_mTrackIsLeft.Clear();
-			m_mTrackIsLeft = null;
+			
+			m_SpawnedTracks = null;
 		}
 		
 		if (m_aBlockedTerrainList)
@@ -1248,6 +1402,21 @@ class SCR_SingleTrackSpawnerComponent : ScriptComponent
 			m_aBlockedTerrainList = null;
 		}
 		
+		if (m_aRibbons)
+		{
+			World world = GetGame().GetWorld();
+			if (world)
+			{
+				float currentTime = world.GetWorldTime();
+				foreach (SCR_TrackRibbon ribbon : m_aRibbons)
+				{
+					ribbon.Clear(world, currentTime);
+				}
+			}
+			m_aRibbons = null;
+		}
+		m_RibbonTrace = null;
+		
 		m_Vehicle = null;
 		m_Simulation = null;
 		m_TerrainDetector = null;
@@ -1272,8 +1441,8 @@ class SCR_SingleTrackSpawnerComponent : ScriptComponent
 	bool IsEnabled() { return m_bEnabled; }
 	int GetSpawnedTrackCount()
 	{
-		if (m_aSpawnedTracks)
-			return m_aSpawnedTracks.Count();
+		if (m_SpawnedTracks)
+			return m_SpawnedTracks.Count();
 		return 0;
 	}
 	static int GetGlobalTrackCount() { return s_iTotalTracksSpawned; }
@@ -391,7 +391,7 @@ class SCR_VehicleTerrainDetectorComponent : ScriptComponent
 				
 				if (markerComp)
 				{
-					PrintFormat("│ Marker Age: %.1fs", markerComp.GetAge());
+					PrintFormat("│ Marker Age: %.1fs", SCR_TrackMarkerGrid.GetInstance().GetAge(markerEntity));
 					PrintFormat("│ Track Length: %.2fm", markerComp.GetTrackLength());
 				}
 				
@@ -481,7 +481,7 @@ class SCR_VehicleTerrainDetectorComponent : ScriptComponent
 				
 				if (markerComp)
 				{
-					PrintFormat("│ Marker Age: %.1fs", markerComp.GetAge());
+					PrintFormat("│ Marker Age: %.1fs", SCR_TrackMarkerGrid.GetInstance().GetAge(markerEntity));
 					PrintFormat("│ Track Length: %.2fm", markerComp.GetTrackLength());
 				}
 				
@@ -688,7 +688,19 @@ class SCR_VehicleTerrainDetectorComponent : ScriptComponent
 		if (!m_bEnableMarkerDetection)
 			return "UNKNOWN";
 		
-		string markerTerrain = SCR_SimpleCollisionMarkerComponent.CheckPositionAgainstAllMarkersWithEntity(
+		//! Segments placed by track spawners are in the grid with their terrain type
+		SCR_TrackMarkerGrid grid = SCR_TrackMarkerGrid.GetInstance();
+		string markerTerrain = grid.FindMarker(position, 0.5, foundMarker, isAligned, vehicleDirection, m_fAlignmentThreshold);
+		if (markerTerrain != "")
+			return markerTerrain;
+		
+		//! Full scan only while markers exist that the grid doesn't know - placed by something else,
+		//! or from a prefab whose terrain type hasn't been learnt yet. Parked pooled markers are known
+		int knownMarkers = grid.GetMarkerCount() + SCR_TrackEntityPool.GetInstance().GetIdleMarkerCount();
+		if (SCR_SimpleCollisionMarkerComponent.GetMarkerCount() <= knownMarkers)
+			return "UNKNOWN";
+		
+		markerTerrain = SCR_SimpleCollisionMarkerComponent.CheckPositionAgainstAllMarkersWithEntity(
 			position, 
 			0.5, 
 			foundMarker, 
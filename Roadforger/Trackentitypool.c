@@ -0,0 +1,174 @@
+//------------------------------------------------------------------------------------------------
+//! Track Entity Pool
+//! Server-wide per-prefab pool of track segment entities
+//! Segments evicted by SCR_SingleTrackSpawnerComponent are hidden and parked below their spot
+//! instead of deleted, and the next segment of the same prefab is the parked entity moved into
+//! place and shown again - no spawn/delete churn while vehicles keep driving
+//! Replicated segments are parked and placed on clients too, through the game mode's broadcast.
+//! A parked SCR_SimpleCollisionMarkerComponent stays registered with its original age - it is out of
+//! reach of every marker check down there, and SCR_TrackMarkerGrid holds the age of the segment's
+//! current placement
+//------------------------------------------------------------------------------------------------
+class SCR_TrackEntityPool
+{
+	protected static ref SCR_TrackEntityPool s_Instance;
+	
+	//! Parked segments sit this far below where they were evicted, out of reach of marker checks
+	protected static const float PARK_DEPTH = 500.0;
+	
+	protected ref map<ResourceName, ref array<IEntity>> m_mIdle = new map<ResourceName, ref array<IEntity>>();
+	protected ref map<ResourceName, bool> m_mHasMarker = new map<ResourceName, bool>();
+	protected int m_iCapacity;
+	protected int m_iIdleCount;
+	protected int m_iIdleMarkerCount;
+	protected int m_iRecycled;
+	
+	//------------------------------------------------------------------------------------------------
+	static SCR_TrackEntityPool GetInstance()
+	{
+		if (!s_Instance)
+			s_Instance = new SCR_TrackEntityPool();
+		return s_Instance;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Idle segments kept per prefab. Only grows - every spawner raises it to what its limits need
+	void EnsureCapacity(int capacity)
+	{
+		if (capacity > m_iCapacity)
+			m_iCapacity = capacity;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	int GetIdleCount()
+	{
+		return m_iIdleCount;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Parked segments with a collision marker - still counted by SCR_SimpleCollisionMarkerComponent
+	int GetIdleMarkerCount()
+	{
+		return m_iIdleMarkerCount;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Segments placed from the pool instead of spawned since the session started
+	int GetRecycledCount()
+	{
+		return m_iRecycled;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Places a segment of the prefab at the transform - a parked one if available, else a new spawn
+	//! of res, the prefab's already loaded resource
+	IEntity Acquire(ResourceName prefab, Resource res, vector transform[4])
+	{
+		array<IEntity> idle;
+		if (m_mIdle.Find(prefab, idle))
+		{
+			while (!idle.IsEmpty())
+			{
+				int last = idle.Count() - 1;
+				IEntity entity = idle[last];
+				idle.Remove(last);
+				m_iIdleCount--;
+				
+				if (m_mHasMarker.Get(prefab))
+					m_iIdleMarkerCount--;
+				
+				//! Deleted while parked (world cleanup, decal removal)
+				if (!entity)
+					continue;
+				
+				PlaceSegment(entity, transform, true);
+				m_iRecycled++;
+				return entity;
+			}
+		}
+		
+		if (!res)
+			return null;
+		
+		EntitySpawnParams params = new EntitySpawnParams();
+		params.TransformMode = ETransformMode.WORLD;
+		params.Transform[0] = transform[0];
+		params.Transform[1] = transform[1];
+		params.Transform[2] = transform[2];
+		params.Transform[3] = transform[3];
+		
+		return GetGame().SpawnEntityPrefab(res, GetGame().GetWorld(), params);
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Hides and parks the segment for reuse, or deletes it when the prefab's pool is full
+	void Release(ResourceName prefab, IEntity entity)
+	{
+		if (!entity)
+			return;
+		
+		if (prefab == "")
+		{
+			SCR_EntityHelper.DeleteEntityAndChildren(entity);
+			return;
+		}
+		
+		array<IEntity> idle;
+		if (!m_mIdle.Find(prefab, idle))
+		{
+			idle = new array<IEntity>();
+			m_mIdle.Insert(prefab, idle);
+		}
+		
+		if (!idle || idle.Count() >= m_iCapacity)
+		{
+			SCR_EntityHelper.DeleteEntityAndChildren(entity);
+			return;
+		}
+		
+		vector transform[4];
+		entity.GetWorldTransform(transform);
+		transform[3] = transform[3] - Vector(0, PARK_DEPTH, 0);
+		PlaceSegment(entity, transform, false);
+		
+		bool hasMarker;
+		if (!m_mHasMarker.Find(prefab, hasMarker))
+		{
+			hasMarker = entity.FindComponent(SCR_SimpleCollisionMarkerComponent) != null;
+			m_mHasMarker.Insert(prefab, hasMarker);
+		}
+		
+		if (hasMarker)
+			m_iIdleMarkerCount++;
+		
+		idle.Insert(entity);
+		m_iIdleCount++;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Moves and shows or hides the segment here, and on every client if it is replicated
+	protected void PlaceSegment(IEntity entity, vector transform[4], bool visible)
+	{
+		ApplyPlacement(entity, transform, visible);
+		
+		RplComponent rpl = RplComponent.Cast(entity.FindComponent(RplComponent));
+		if (!rpl)
+			return;
+		
+		SCR_BaseGameMode gameMode = SCR_BaseGameMode.Cast(GetGame().GetGameMode());
+		if (gameMode)
+			gameMode.BroadcastTrackSegmentPlaced(rpl.Id(), Math3D.MatrixToAngles(transform), transform[3], visible);
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	static void ApplyPlacement(IEntity entity, vector transform[4], bool visible)
+	{
+		if (visible)
+			entity.SetFlags(EntityFlags.VISIBLE, true);
+		else
+			entity.ClearFlags(EntityFlags.VISIBLE, true);
+		
+		entity.SetWorldTransform(transform);
+		entity.Update();
+	}
+}
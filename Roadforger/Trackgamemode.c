@@ -0,0 +1,34 @@
+//------------------------------------------------------------------------------------------------
+//! Track Game Mode
+//! Replication channel for SCR_TrackEntityPool - the pool is not an entity, so a replicated
+//! segment it parks or places again is announced through the game mode, which every client has
+//! Server sends, every client receives
+//------------------------------------------------------------------------------------------------
+modded class SCR_BaseGameMode
+{
+	//------------------------------------------------------------------------------------------------
+	//! Server: moves a replicated track segment on every client. The caller has moved it locally
+	void BroadcastTrackSegmentPlaced(RplId segmentId, vector angles, vector position, bool visible)
+	{
+		Rpc(RpcDo_TrackSegmentPlaced, segmentId, angles, position, visible);
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Segments a client hasn't streamed in arrive later at their current placement
+	[RplRpc(RplChannel.Reliable, RplRcver.Broadcast)]
+	protected void RpcDo_TrackSegmentPlaced(RplId segmentId, vector angles, vector position, bool visible)
+	{
+		RplComponent rpl = RplComponent.Cast(Replication.FindItem(segmentId));
+		if (!rpl)
+			return;
+		
+		IEntity segment = rpl.GetEntity();
+		if (!segment)
+			return;
+		
+		vector transform[4];
+		Math3D.AnglesToMatrix(angles, transform);
+		transform[3] = position;
+		SCR_TrackEntityPool.ApplyPlacement(segment, transform, visible);
+	}
+}
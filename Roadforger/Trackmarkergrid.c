@@ -0,0 +1,358 @@
+//------------------------------------------------------------------------------------------------
+//! Track Marker Grid
+//! Server-wide uniform grid of the track segments placed by SCR_SingleTrackSpawnerComponent
+//! Stores centre, direction, half length, side, owner, spawn time and marker terrain of every
+//! segment so proximity, alignment and terrain checks only look at the cells around the query point
+//------------------------------------------------------------------------------------------------
+class SCR_TrackMarkerGrid
+{
+	protected static ref SCR_TrackMarkerGrid s_Instance;
+	
+	protected static const float CELL_SIZE = 4.0;
+	
+	//! Records - struct of arrays, all index-aligned. Removal moves the last record into the hole
+	protected ref array<int> m_aId = new array<int>();
+	protected ref array<IEntity> m_aEntity = new array<IEntity>();
+	protected ref array<IEntity> m_aOwner = new array<IEntity>();
+	protected ref array<vector> m_aCenter = new array<vector>();
+	protected ref array<vector> m_aDirection = new array<vector>();
+	protected ref array<float> m_aHalfLength = new array<float>();
+	protected ref array<bool> m_aIsLeft = new array<bool>();
+	protected ref array<float> m_aSpawnTime = new array<float>();
+	protected ref array<string> m_aTerrain = new array<string>();
+	protected ref array<int> m_aCellKey = new array<int>();
+	
+	protected ref map<int, int> m_mIdIndex = new map<int, int>();
+	protected ref map<int, ref array<int>> m_mCells = new map<int, ref array<int>>();
+	
+	protected ref array<int> m_aDeadIds = new array<int>();
+	protected int m_iNextId = 1;
+	protected int m_iMarkerCount;
+	protected float m_fMaxHalfLength;
+	
+	//------------------------------------------------------------------------------------------------
+	static SCR_TrackMarkerGrid GetInstance()
+	{
+		if (!s_Instance)
+			s_Instance = new SCR_TrackMarkerGrid();
+		return s_Instance;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	int GetCount()
+	{
+		return m_aId.Count();
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Segments stored with a marker terrain - compared against SCR_SimpleCollisionMarkerComponent's
+	//! own count to tell whether markers exist that the grid doesn't know
+	int GetMarkerCount()
+	{
+		return m_iMarkerCount;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Adds a segment and returns its id (never 0). terrain is the terrain type of the segment's
+	//! collision marker, empty if it has none
+	int Insert(IEntity entity, IEntity owner, vector center, vector direction, float halfLength, bool isLeft, float spawnTime, string terrain = "")
+	{
+		vector flatDir = direction;
+		flatDir[1] = 0;
+		flatDir.Normalize();
+		
+		int id = m_iNextId;
+		m_iNextId++;
+		
+		int key = GetCellKey(center[0], center[2]);
+		int index = m_aId.Insert(id);
+		m_aEntity.Insert(entity);
+		m_aOwner.Insert(owner);
+		m_aCenter.Insert(center);
+		m_aDirection.Insert(flatDir);
+		m_aHalfLength.Insert(halfLength);
+		m_aIsLeft.Insert(isLeft);
+		m_aSpawnTime.Insert(spawnTime);
+		m_aTerrain.Insert(terrain);
+		m_aCellKey.Insert(key);
+		m_mIdIndex.Insert(id, index);
+		
+		if (terrain != "")
+			m_iMarkerCount++;
+		
+		array<int> bucket;
+		if (!m_mCells.Find(key, bucket))
+		{
+			bucket = new array<int>();
+			m_mCells.Insert(key, bucket);
+		}
+		bucket.Insert(index);
+		
+		if (halfLength > m_fMaxHalfLength)
+			m_fMaxHalfLength = halfLength;
+		
+		return id;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	void Remove(int id)
+	{
+		int index;
+		if (!m_mIdIndex.Find(id, index))
+			return;
+		
+		m_mIdIndex.Remove(id);
+		RemoveFromBucket(m_aCellKey[index], index);
+		
+		if (m_aTerrain[index] != "")
+			m_iMarkerCount--;
+		
+		int last = m_aId.Count() - 1;
+		if (index != last)
+		{
+			//! The last record moves into the hole - repoint its bucket entry
+			array<int> movedBucket = m_mCells.Get(m_aCellKey[last]);
+			int slot = movedBucket.Find(last);
+			if (slot != -1)
+				movedBucket[slot] = index;
+			
+			m_aId[index] = m_aId[last];
+			m_aEntity[index] = m_aEntity[last];
+			m_aOwner[index] = m_aOwner[last];
+			m_aCenter[index] = m_aCenter[last];
+			m_aDirection[index] = m_aDirection[last];
+			m_aHalfLength[index] = m_aHalfLength[last];
+			m_aIsLeft[index] = m_aIsLeft[last];
+			m_aSpawnTime[index] = m_aSpawnTime[last];
+			m_aTerrain[index] = m_aTerrain[last];
+			m_aCellKey[index] = m_aCellKey[last];
+			m_mIdIndex.Set(m_aId[index], index);
+		}
+		
+		m_aId.Remove(last);
+		m_aEntity.Remove(last);
+		m_aOwner.Remove(last);
+		m_aCenter.Remove(last);
+		m_aDirection.Remove(last);
+		m_aHalfLength.Remove(last);
+		m_aIsLeft.Remove(last);
+		m_aSpawnTime.Remove(last);
+		m_aTerrain.Remove(last);
+		m_aCellKey.Remove(last);
+		
+		if (m_aId.IsEmpty())
+			m_fMaxHalfLength = 0;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! True if a segment of this owner and side has its centre within radius
+	bool HasTrackNearby(vector position, float radius, IEntity owner, bool isLeft)
+	{
+		bool found = false;
+		float radiusSq = radius * radius;
+		
+		int minX = Math.Floor((position[0] - radius) / CELL_SIZE);
+		int maxX = Math.Floor((position[0] + radius) / CELL_SIZE);
+		int minZ = Math.Floor((position[2] - radius) / CELL_SIZE);
+		int maxZ = Math.Floor((position[2] + radius) / CELL_SIZE);
+		
+		for (int x = minX; x <= maxX && !found; x++)
+		{
+			for (int z = minZ; z <= maxZ && !found; z++)
+			{
+				array<int> bucket;
+				if (!m_mCells.Find(MakeKey(x, z), bucket))
+					continue;
+				
+				foreach (int index : bucket)
+				{
+					if (!m_aEntity[index])
+					{
+						m_aDeadIds.Insert(m_aId[index]);
+						continue;
+					}
+					
+					if (m_aOwner[index] != owner || m_aIsLeft[index] != isLeft)
+						continue;
+					
+					if (vector.DistanceSq(position, m_aCenter[index]) < radiusSq)
+					{
+						found = true;
+						break;
+					}
+				}
+			}
+		}
+		
+		PruneDead();
+		return found;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Seconds since the segment was placed, -1 if the grid doesn't hold it. Unlike the marker's
+	//! own GetAge this restarts when SCR_TrackEntityPool places a parked segment again
+	float GetAge(IEntity entity)
+	{
+		if (!entity)
+			return -1;
+		
+		//! Segments are stored at their own origin
+		vector origin = entity.GetOrigin();
+		array<int> bucket;
+		if (!m_mCells.Find(GetCellKey(origin[0], origin[2]), bucket))
+			return -1;
+		
+		foreach (int index : bucket)
+		{
+			if (m_aEntity[index] == entity)
+				return (GetGame().GetWorld().GetWorldTime() - m_aSpawnTime[index]) * 0.001;
+		}
+		
+		return -1;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Finds a segment of any vehicle whose length passes within radius of the position and that is
+	//! older than minAge seconds. With alignThreshold > 0 the segment must also run along direction
+	//! (either way) with |dot| >= alignThreshold
+	IEntity FindTrack(vector position, float radius, float minAge, vector direction = vector.Zero, float alignThreshold = 0)
+	{
+		float maxSpawnTime = GetGame().GetWorld().GetWorldTime() - minAge * 1000;
+		int index = FindSegment(position, radius, maxSpawnTime, direction, alignThreshold, false);
+		if (index == -1)
+			return null;
+		
+		return m_aEntity[index];
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Grid version of SCR_SimpleCollisionMarkerComponent.CheckPositionAgainstAllMarkersWithEntity
+	//! Finds a segment with a collision marker whose length passes within radius of the position and
+	//! returns its terrain type, empty if there is none. isAligned tells whether it runs along
+	//! direction (either way) with |dot| >= alignThreshold
+	string FindMarker(vector position, float radius, out IEntity marker, out bool isAligned, vector direction, float alignThreshold)
+	{
+		marker = null;
+		isAligned = false;
+		
+		int index = FindSegment(position, radius, float.MAX, vector.Zero, 0, true);
+		if (index == -1)
+			return "";
+		
+		vector flatDir = direction;
+		flatDir[1] = 0;
+		flatDir.Normalize();
+		
+		marker = m_aEntity[index];
+		isAligned = Math.AbsFloat(vector.Dot(m_aDirection[index], flatDir)) >= alignThreshold;
+		return m_aTerrain[index];
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Index of the first live segment passing within radius whose spawn time is before maxSpawnTime,
+	//! -1 if none. Dead records met on the way are pruned before the index is returned
+	protected int FindSegment(vector position, float radius, float maxSpawnTime, vector direction, float alignThreshold, bool markersOnly)
+	{
+		int resultId;
+		float radiusSq = radius * radius;
+		float extent = radius + m_fMaxHalfLength;
+		
+		vector flatDir = direction;
+		flatDir[1] = 0;
+		flatDir.Normalize();
+		
+		int minX = Math.Floor((position[0] - extent) / CELL_SIZE);
+		int maxX = Math.Floor((position[0] + extent) / CELL_SIZE);
+		int minZ = Math.Floor((position[2] - extent) / CELL_SIZE);
+		int maxZ = Math.Floor((position[2] + extent) / CELL_SIZE);
+		
+		for (int x = minX; x <= maxX && resultId == 0; x++)
+		{
+			for (int z = minZ; z <= maxZ && resultId == 0; z++)
+			{
+				array<int> bucket;
+				if (!m_mCells.Find(MakeKey(x, z), bucket))
+					continue;
+				
+				foreach (int index : bucket)
+				{
+					if (!m_aEntity[index])
+					{
+						m_aDeadIds.Insert(m_aId[index]);
+						continue;
+					}
+					
+					if (m_aSpawnTime[index] >= maxSpawnTime)
+						continue;
+					
+					if (markersOnly && m_aTerrain[index] == "")
+						continue;
+					
+					vector segDir = m_aDirection[index];
+					if (alignThreshold > 0 && Math.AbsFloat(vector.Dot(segDir, flatDir)) < alignThreshold)
+						continue;
+					
+					//! Closest point on the segment's centre line
+					vector center = m_aCenter[index];
+					float halfLength = m_aHalfLength[index];
+					float t = Math.Clamp(vector.Dot(position - center, segDir), -halfLength, halfLength);
+					vector closest = center + segDir * t;
+					
+					if (vector.DistanceSq(position, closest) < radiusSq)
+					{
+						resultId = m_aId[index];
+						break;
+					}
+				}
+			}
+		}
+		
+		//! Pruning moves records around - look the result up again afterwards
+		PruneDead();
+		
+		int resultIndex;
+		if (resultId == 0 || !m_mIdIndex.Find(resultId, resultIndex))
+			return -1;
+		
+		return resultIndex;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Segments deleted by someone else (decal removal, streaming) are dropped when a query meets them
+	protected void PruneDead()
+	{
+		if (m_aDeadIds.IsEmpty())
+			return;
+		
+		foreach (int id : m_aDeadIds)
+		{
+			Remove(id);
+		}
+		m_aDeadIds.Clear();
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	protected void RemoveFromBucket(int key, int index)
+	{
+		array<int> bucket;
+		if (!m_mCells.Find(key, bucket))
+			return;
+		
+		bucket.RemoveItem(index);
+		if (bucket.IsEmpty())
+			m_mCells.Remove(key);
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	protected int GetCellKey(float x, float z)
+	{
+		return MakeKey(Math.Floor(x / CELL_SIZE), Math.Floor(z / CELL_SIZE));
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! 16 bits per axis - wraps every 262 km, far beyond any terrain
+	protected int MakeKey(int x, int z)
+	{
+		return ((x & 0xFFFF) << 16) | (z & 0xFFFF);
+	}
+}
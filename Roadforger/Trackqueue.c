@@ -0,0 +1,84 @@
+//------------------------------------------------------------------------------------------------
+//! Spawned Track Queue
+//! Segments of one SCR_SingleTrackSpawnerComponent in spawn order, oldest first
+//! Ring buffer of index-aligned slots. The spawner keeps it near m_iMaxTracksPerVehicle, so the
+//! slots are reused in place; it only doubles when a vehicle ignores its limits
+//------------------------------------------------------------------------------------------------
+class SCR_SpawnedTrackQueue
+{
+	protected static const int INITIAL_CAPACITY = 16;
+	
+	protected ref array<IEntity> m_aTracks = new array<IEntity>();
+	protected ref array<int> m_aGridIds = new array<int>();
+	protected ref array<ResourceName> m_aPrefabs = new array<ResourceName>();
+	protected int m_iHead;
+	protected int m_iCount;
+	
+	//------------------------------------------------------------------------------------------------
+	int Count()
+	{
+		return m_iCount;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	bool IsEmpty()
+	{
+		return m_iCount == 0;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	void Push(IEntity track, int gridId, ResourceName prefab)
+	{
+		if (m_iCount == m_aTracks.Count())
+			Grow();
+		
+		int index = (m_iHead + m_iCount) % m_aTracks.Count();
+		m_aTracks[index] = track;
+		m_aGridIds[index] = gridId;
+		m_aPrefabs[index] = prefab;
+		m_iCount++;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Removes the oldest record and returns its entity - null if something else deleted it
+	IEntity Pop(out int gridId, out ResourceName prefab)
+	{
+		int index = m_iHead;
+		IEntity track = m_aTracks[index];
+		gridId = m_aGridIds[index];
+		prefab = m_aPrefabs[index];
+		m_aTracks[index] = null;
+		
+		m_iHead = (m_iHead + 1) % m_aTracks.Count();
+		m_iCount--;
+		
+		return track;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Doubles the slots and unrolls the records so the oldest one sits at index 0 again
+	protected void Grow()
+	{
+		int capacity = Math.Max(INITIAL_CAPACITY, m_aTracks.Count() * 2);
+		
+		array<IEntity> tracks = new array<IEntity>();
+		array<int> gridIds = new array<int>();
+		array<ResourceName> prefabs = new array<ResourceName>();
+		tracks.Resize(capacity);
+		gridIds.Resize(capacity);
+		prefabs.Resize(capacity);
+		
+		for (int i = 0; i < m_iCount; i++)
+		{
+			int index = (m_iHead + i) % m_aTracks.Count();
+			tracks[i] = m_aTracks[index];
+			gridIds[i] = m_aGridIds[index];
+			prefabs[i] = m_aPrefabs[index];
+		}
+		
+		m_aTracks = tracks;
+		m_aGridIds = gridIds;
+		m_aPrefabs = prefabs;
+		m_iHead = 0;
+	}
+}
@@ -0,0 +1,169 @@
+//------------------------------------------------------------------------------------------------
+//! Track Ribbon
+//! One wheel's tyre track drawn as a continuous strip of chained track decals
+//! Contact points are appended to the current decal; every m_iChunkPoints points the strip
+//! continues in a new decal chained to the previous one. Chunks live in a ring buffer - when it
+//! is full the oldest chunk is removed, so a trail is a handful of decals instead of hundreds of
+//! segment entities. Local visual only, never replicated
+//------------------------------------------------------------------------------------------------
+class SCR_TrackRibbon
+{
+	protected ResourceName m_sMaterial;
+	protected float m_fWidth;
+	protected float m_fLifetime;
+	protected int m_iChunkPoints;
+	
+	//! Chunk ring buffer - m_iChunkHead is the oldest, m_iChunkCount the number in use
+	protected ref array<TrackDecal> m_aChunks = new array<TrackDecal>();
+	protected ref array<float> m_aChunkTimes = new array<float>();
+	protected int m_iChunkHead;
+	protected int m_iChunkCount;
+	
+	protected TrackDecal m_CurrentDecal;
+	protected IEntity m_CurrentSurface;
+	protected int m_iCurrentPoints;
+	protected vector m_vLastPoint;
+	protected vector m_vLastNormal;
+	protected bool m_bHasLastPoint;
+	
+	//------------------------------------------------------------------------------------------------
+	void SCR_TrackRibbon(ResourceName material, float width, float lifetime, int chunkPoints, int maxPoints)
+	{
+		m_sMaterial = material;
+		m_fWidth = width;
+		m_fLifetime = lifetime;
+		m_iChunkPoints = Math.Max(chunkPoints, 2);
+		
+		//! At least two, so the chunk a new one chains from is never the one evicted for it
+		int maxChunks = Math.Max(maxPoints / m_iChunkPoints, 2);
+		m_aChunks.Resize(maxChunks);
+		m_aChunkTimes.Resize(maxChunks);
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	bool HasLastPoint()
+	{
+		return m_bHasLastPoint;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	vector GetLastPoint()
+	{
+		return m_vLastPoint;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	int GetChunkCount()
+	{
+		return m_iChunkCount;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Appends a contact point on surface. Starts a new chained chunk when the current one is full
+	//! or the decal cannot take the point (different surface entity, too sharp a turn)
+	void AddPoint(World world, IEntity surface, vector position, vector normal, float time)
+	{
+		if (m_CurrentDecal)
+		{
+			bool canAdd = m_iCurrentPoints < m_iChunkPoints && surface == m_CurrentSurface;
+			if (canAdd && m_CurrentDecal.CanAddToTrackDecal(surface, m_sMaterial, position) == 0)
+			{
+				m_CurrentDecal.AddPointToTrackDecal(position, normal, 1.0);
+				m_iCurrentPoints++;
+				m_vLastPoint = position;
+				m_vLastNormal = normal;
+				return;
+			}
+			
+			//! Chain the next chunk from the last point so the strip has no gap
+			TrackDecal prevDecal = m_CurrentDecal;
+			m_CurrentDecal.FinalizeTrackDecal(false, 0);
+			m_CurrentDecal = null;
+			
+			if (surface == m_CurrentSurface)
+			{
+				StartChunk(world, surface, m_vLastPoint, m_vLastNormal, time, prevDecal);
+				if (m_CurrentDecal)
+				{
+					m_CurrentDecal.AddPointToTrackDecal(position, normal, 1.0);
+					m_iCurrentPoints++;
+				}
+				
+				m_vLastPoint = position;
+				m_vLastNormal = normal;
+				m_bHasLastPoint = true;
+				return;
+			}
+		}
+		
+		StartChunk(world, surface, position, normal, time, null);
+		m_vLastPoint = position;
+		m_vLastNormal = normal;
+		m_bHasLastPoint = true;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Ends the strip - the next point starts an unconnected one (wheel lifted, blocked terrain)
+	void Break()
+	{
+		if (m_CurrentDecal)
+			m_CurrentDecal.FinalizeTrackDecal(false, 0);
+		
+		m_CurrentDecal = null;
+		m_CurrentSurface = null;
+		m_iCurrentPoints = 0;
+		m_bHasLastPoint = false;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Removes every chunk that has not faded out yet
+	void Clear(World world, float time)
+	{
+		Break();
+		
+		while (m_iChunkCount > 0)
+			RemoveOldestChunk(world, time);
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	protected void StartChunk(World world, IEntity surface, vector position, vector normal, float time, TrackDecal prevDecal)
+	{
+		if (m_iChunkCount == m_aChunks.Count())
+			RemoveOldestChunk(world, time);
+		
+		m_CurrentDecal = world.CreateTrackDecal(surface, position, normal, m_fWidth, m_fLifetime, m_sMaterial, prevDecal, 1.0);
+		m_CurrentSurface = surface;
+		m_iCurrentPoints = 1;
+		
+		if (!m_CurrentDecal)
+			return;
+		
+		int tail = (m_iChunkHead + m_iChunkCount) % m_aChunks.Count();
+		m_aChunks[tail] = m_CurrentDecal;
+		m_aChunkTimes[tail] = time;
+		m_iChunkCount++;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	protected void RemoveOldestChunk(World world, float time)
+	{
+		TrackDecal oldest = m_aChunks[m_iChunkHead];
+		
+		//! Chunks past their lifetime are already gone - only live ones are removed
+		if (oldest && time - m_aChunkTimes[m_iChunkHead] < m_fLifetime * 1000)
+		{
+			if (oldest == m_CurrentDecal)
+			{
+				m_CurrentDecal = null;
+				m_CurrentSurface = null;
+				m_iCurrentPoints = 0;
+			}
+			
+			world.RemoveDecal(oldest);
+		}
+		
+		m_aChunks[m_iChunkHead] = null;
+		m_iChunkHead = (m_iChunkHead + 1) % m_aChunks.Count();
+		m_iChunkCount--;
+	}
+}
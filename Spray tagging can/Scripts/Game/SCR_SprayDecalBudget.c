@@ -0,0 +1,299 @@
+//------------------------------------------------------------------------------------------------
+//! FIFO of decal entries in placement order, shared by the budget queues and the compactor.
+//! Pop releases the slot and steps past it; the array is only rebuilt when more than half of it
+//! (and at least MIN_REBUILD_SLOTS) is released slots, so evicting never shifts the whole queue.
+class SCR_SprayDecalQueue
+{
+	protected static const int MIN_REBUILD_SLOTS = 64;
+
+	protected ref array<ref SCR_SprayPositionEntry> m_aEntries = new array<ref SCR_SprayPositionEntry>();
+	protected int m_iHead;
+
+	//------------------------------------------------------------------------------------------------
+	void Push(SCR_SprayPositionEntry entry)
+	{
+		m_aEntries.Insert(entry);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Oldest entry still queued, or null when empty
+	SCR_SprayPositionEntry Peek()
+	{
+		if (m_iHead >= m_aEntries.Count())
+			return null;
+
+		return m_aEntries[m_iHead];
+	}
+
+	//------------------------------------------------------------------------------------------------
+	void Pop()
+	{
+		if (m_iHead >= m_aEntries.Count())
+			return;
+
+		m_aEntries[m_iHead] = null;
+		m_iHead++;
+
+		if (m_iHead >= m_aEntries.Count())
+		{
+			m_aEntries.Clear();
+			m_iHead = 0;
+		}
+		else if (m_iHead > MIN_REBUILD_SLOTS && m_iHead * 2 > m_aEntries.Count())
+		{
+			array<ref SCR_SprayPositionEntry> compacted = new array<ref SCR_SprayPositionEntry>();
+			for (int i = m_iHead; i < m_aEntries.Count(); i++)
+			{
+				compacted.Insert(m_aEntries[i]);
+			}
+
+			m_aEntries = compacted;
+			m_iHead = 0;
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	bool IsEmpty()
+	{
+		return m_iHead >= m_aEntries.Count();
+	}
+}
+
+//------------------------------------------------------------------------------------------------
+//! Caps the number of live spray decals, globally and per player.
+//! When a cap is hit the least-recently-placed decal is evicted through World.RemoveDecal.
+//! Released entries (expired or covered) stay in the queues and are skipped lazily.
+class SCR_SprayDecalBudget
+{
+	protected static ref SCR_SprayDecalBudget s_Instance;
+
+	protected int m_iGlobalCap = 1500;
+	protected int m_iPlayerQuota = 300;
+	protected bool m_bLimitsConfigured;
+	protected int m_iLiveCount;
+	protected int m_iEvictedCount;
+
+	protected ref SCR_SprayDecalQueue m_GlobalQueue = new SCR_SprayDecalQueue();
+	protected ref map<int, ref SCR_SprayDecalQueue> m_mPlayerQueues = new map<int, ref SCR_SprayDecalQueue>();
+	protected ref map<int, int> m_mPlayerCounts = new map<int, int>();
+
+	//------------------------------------------------------------------------------------------------
+	static SCR_SprayDecalBudget GetInstance()
+	{
+		if (!s_Instance)
+			s_Instance = new SCR_SprayDecalBudget();
+
+		return s_Instance;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! 0 disables the respective limit. Every spray prefab reports its limits, so the first report
+	//! replaces the defaults and later ones can only tighten them — the order projectiles spawn in
+	//! doesn't decide the session's budget.
+	void SetLimits(int globalCap, int playerQuota)
+	{
+		if (!m_bLimitsConfigured)
+		{
+			m_bLimitsConfigured = true;
+			m_iGlobalCap = globalCap;
+			m_iPlayerQuota = playerQuota;
+			return;
+		}
+
+		m_iGlobalCap = TightestLimit(m_iGlobalCap, globalCap);
+		m_iPlayerQuota = TightestLimit(m_iPlayerQuota, playerQuota);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected static int TightestLimit(int current, int requested)
+	{
+		if (current <= 0)
+			return requested;
+
+		if (requested <= 0)
+			return current;
+
+		return Math.Min(current, requested);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	int GetGlobalCap()
+	{
+		return m_iGlobalCap;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	int GetPlayerQuota()
+	{
+		return m_iPlayerQuota;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	int GetLiveCount()
+	{
+		return m_iLiveCount;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	int GetPlayerLiveCount(int playerId)
+	{
+		return m_mPlayerCounts.Get(playerId);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Total decals evicted by the budget since the session started
+	int GetEvictedCount()
+	{
+		return m_iEvictedCount;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	void PrintStats()
+	{
+		Print(string.Format("[SprayDecalBudget] Live: %1 / %2 | Players: %3 | Quota: %4 | Evicted: %5",
+			m_iLiveCount, m_iGlobalCap, m_mPlayerCounts.Count(), m_iPlayerQuota, m_iEvictedCount), LogLevel.NORMAL);
+
+		foreach (int playerId, int count : m_mPlayerCounts)
+		{
+			Print(string.Format("[SprayDecalBudget]   Player %1: %2", playerId, count), LogLevel.NORMAL);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Registers a freshly placed decal and evicts older ones until both limits hold again.
+	//! Evicted entries are appended to outEvicted so the caller can drop them from its spatial index.
+	void Register(notnull World world, notnull SCR_SprayPositionEntry entry, int playerId, notnull array<SCR_SprayPositionEntry> outEvicted)
+	{
+		outEvicted.Clear();
+
+		entry.m_iPlayerId = playerId;
+		entry.m_bBudgetReleased = false;
+
+		m_GlobalQueue.Push(entry);
+
+		SCR_SprayDecalQueue playerQueue = m_mPlayerQueues.Get(playerId);
+		if (!playerQueue)
+		{
+			playerQueue = new SCR_SprayDecalQueue();
+			m_mPlayerQueues.Insert(playerId, playerQueue);
+		}
+		playerQueue.Push(entry);
+
+		m_iLiveCount++;
+		m_mPlayerCounts.Set(playerId, m_mPlayerCounts.Get(playerId) + 1);
+
+		if (m_iPlayerQuota > 0)
+		{
+			while (m_mPlayerCounts.Get(playerId) > m_iPlayerQuota)
+			{
+				SCR_SprayPositionEntry oldest = PopOldestLive(playerQueue, entry);
+				if (!oldest)
+					break;
+
+				Evict(world, oldest, outEvicted);
+			}
+		}
+
+		if (m_iGlobalCap > 0)
+		{
+			while (m_iLiveCount > m_iGlobalCap)
+			{
+				SCR_SprayPositionEntry oldest = PopOldestLive(m_GlobalQueue, entry);
+				if (!oldest)
+					break;
+
+				Evict(world, oldest, outEvicted);
+			}
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Call when a decal leaves the world for any reason other than budget eviction
+	void Release(notnull SCR_SprayPositionEntry entry)
+	{
+		if (entry.m_bBudgetReleased)
+			return;
+
+		entry.m_bBudgetReleased = true;
+		m_iLiveCount--;
+
+		int count = m_mPlayerCounts.Get(entry.m_iPlayerId) - 1;
+		if (count > 0)
+		{
+			m_mPlayerCounts.Set(entry.m_iPlayerId, count);
+
+			SCR_SprayDecalQueue playerQueue = m_mPlayerQueues.Get(entry.m_iPlayerId);
+			if (playerQueue)
+				DropReleasedHead(playerQueue);
+
+			return;
+		}
+
+		m_mPlayerCounts.Remove(entry.m_iPlayerId);
+		m_mPlayerQueues.Remove(entry.m_iPlayerId);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Drops released and expired entries off the queue fronts so counts don't lag behind lifetimes
+	void PurgeExpired(float currentTimeMs)
+	{
+		while (true)
+		{
+			SCR_SprayPositionEntry head = m_GlobalQueue.Peek();
+			if (!head)
+				break;
+
+			if (!head.m_bBudgetReleased && head.m_fExpiryMs > currentTimeMs)
+				break;
+
+			m_GlobalQueue.Pop();
+			Release(head);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Pops released entries off the front of a player's queue. Release trims after every decal that
+	//! leaves, so a player's queue never holds more than its live decals plus those stuck behind them.
+	protected void DropReleasedHead(SCR_SprayDecalQueue queue)
+	{
+		while (true)
+		{
+			SCR_SprayPositionEntry head = queue.Peek();
+			if (!head || !head.m_bBudgetReleased)
+				break;
+
+			queue.Pop();
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Pops and returns the oldest live entry. Stops without popping at keep, the decal being registered.
+	protected SCR_SprayPositionEntry PopOldestLive(SCR_SprayDecalQueue queue, SCR_SprayPositionEntry keep)
+	{
+		while (!queue.IsEmpty())
+		{
+			SCR_SprayPositionEntry head = queue.Peek();
+			if (head == keep)
+				return null;
+
+			queue.Pop();
+
+			if (!head.m_bBudgetReleased)
+				return head;
+		}
+
+		return null;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void Evict(World world, SCR_SprayPositionEntry entry, array<SCR_SprayPositionEntry> outEvicted)
+	{
+		if (entry.m_decal)
+			world.RemoveDecal(entry.m_decal);
+
+		entry.m_decal = null;
+		Release(entry);
+		m_iEvictedCount++;
+		outEvicted.Insert(entry);
+	}
+}
@@ -0,0 +1,293 @@
+//------------------------------------------------------------------------------------------------
+//! Background pass that replaces clusters of overlapping free-paint decals with fewer, larger ones.
+//! Every compactable decal is queued as a seed when it is placed. A pass starts a while after the
+//! first new seed and drains the queue over as many frames as its per-frame time budget needs.
+//! A cluster is only merged when it covers most of the merged footprint and nothing else is painted
+//! inside that footprint, so dense tags keep their look with a fraction of the decals.
+class SCR_SprayDecalCompactor
+{
+	protected static ref SCR_SprayDecalCompactor s_Instance;
+
+	// Decals on a different plane than the seed (other side of a thin wall, a step) never merge
+	protected static const float NORMAL_MATCH_COS = 0.95;
+	protected static const float PLANE_TOLERANCE = 0.1;
+	protected static const int MAX_CLUSTER_SIZE = 64;
+	protected static const float MIN_MERGED_LIFETIME = 2.0;
+
+	protected bool m_bEnabled = true;
+	protected int m_iIntervalMs = 5000;
+	protected int m_iFrameBudgetMs = 1;
+	protected int m_iMinClusterSize = 6;
+	protected float m_fMaxMergedSize = 2.0;
+	protected float m_fMinCoverage = 0.8;
+
+	protected bool m_bPassScheduled;
+	protected bool m_bPassRunning;
+	protected int m_iMergedClusters;
+	protected int m_iRemovedDecals;
+
+	protected ref SCR_SprayDecalQueue m_Seeds = new SCR_SprayDecalQueue();
+	protected ref array<SCR_SprayPositionEntry> m_aCandidates = new array<SCR_SprayPositionEntry>();
+	protected ref array<SCR_SprayPositionEntry> m_aCluster = new array<SCR_SprayPositionEntry>();
+
+	// Graffiti layer records of each cluster member, held aside while the merged decal is registered
+	protected ref array<ref array<SCR_SprayGraffitiRecord>> m_aClusterRecords = new array<ref array<SCR_SprayGraffitiRecord>>();
+
+	//------------------------------------------------------------------------------------------------
+	static SCR_SprayDecalCompactor GetInstance()
+	{
+		if (!s_Instance)
+			s_Instance = new SCR_SprayDecalCompactor();
+
+		return s_Instance;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	void Configure(bool enabled, float intervalSeconds, int frameBudgetMs, int minClusterSize, float maxMergedSize, float minCoverage)
+	{
+		m_bEnabled = enabled;
+		m_iIntervalMs = Math.Max(intervalSeconds * 1000, 100);
+		m_iFrameBudgetMs = Math.Max(frameBudgetMs, 1);
+		m_iMinClusterSize = Math.Max(minClusterSize, 2);
+		m_fMaxMergedSize = maxMergedSize;
+		m_fMinCoverage = minCoverage;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Clusters merged since the session started
+	int GetMergedClusterCount()
+	{
+		return m_iMergedClusters;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Decals saved by merging since the session started
+	int GetRemovedDecalCount()
+	{
+		return m_iRemovedDecals;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Queues a freshly placed compactable decal and schedules a pass if none is pending
+	void Enqueue(notnull SCR_SprayPositionEntry entry)
+	{
+		if (!m_bEnabled)
+			return;
+
+		m_Seeds.Push(entry);
+
+		if (m_bPassScheduled || m_bPassRunning)
+			return;
+
+		m_bPassScheduled = true;
+		GetGame().GetCallqueue().CallLater(StartPass, m_iIntervalMs, false);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void StartPass()
+	{
+		m_bPassScheduled = false;
+		m_bPassRunning = true;
+		Step();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Works through seeds until the frame budget is spent, then continues next frame
+	protected void Step()
+	{
+		World world = GetGame().GetWorld();
+		if (!world || !m_bEnabled)
+		{
+			while (!m_Seeds.IsEmpty())
+			{
+				m_Seeds.Pop();
+			}
+
+			m_bPassRunning = false;
+			return;
+		}
+
+		int start = System.GetTickCount();
+		while (!m_Seeds.IsEmpty())
+		{
+			SCR_SprayPositionEntry seed = m_Seeds.Peek();
+			m_Seeds.Pop();
+			CompactAround(world, seed);
+
+			if (System.GetTickCount() - start >= m_iFrameBudgetMs)
+				break;
+		}
+
+		if (m_Seeds.IsEmpty())
+		{
+			m_bPassRunning = false;
+			return;
+		}
+
+		GetGame().GetCallqueue().CallLater(Step, 0, false);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void CompactAround(World world, SCR_SprayPositionEntry seed)
+	{
+		if (!IsLive(seed) || !seed.m_bCompactable || seed.m_fSize >= m_fMaxMergedSize)
+			return;
+
+		float maxRadius = m_fMaxMergedSize * 0.5;
+		SCR_SprayDecalGrid grid = SCR_SprayProjectile.GetDecalGrid();
+
+		// Same-paint decals that would still fit a max-size decal centred on the seed
+		grid.Query(seed.m_vPos, maxRadius, m_aCandidates);
+		for (int i = m_aCandidates.Count() - 1; i >= 0; i--)
+		{
+			SCR_SprayPositionEntry candidate = m_aCandidates[i];
+			if (candidate == seed || !IsLive(candidate) || !IsSamePaint(seed, candidate) || vector.Distance(seed.m_vPos, candidate.m_vPos) + candidate.m_fSize * 0.5 > maxRadius)
+				m_aCandidates.Remove(i);
+		}
+
+		// Grow the cluster through overlaps, moving candidates over as they join
+		m_aCluster.Clear();
+		m_aCluster.Insert(seed);
+		for (int memberIdx = 0; memberIdx < m_aCluster.Count() && m_aCluster.Count() < MAX_CLUSTER_SIZE; memberIdx++)
+		{
+			SCR_SprayPositionEntry member = m_aCluster[memberIdx];
+			for (int candidateIdx = m_aCandidates.Count() - 1; candidateIdx >= 0; candidateIdx--)
+			{
+				SCR_SprayPositionEntry neighbour = m_aCandidates[candidateIdx];
+				float overlap = (member.m_fSize + neighbour.m_fSize) * 0.5;
+				if (vector.DistanceSq(member.m_vPos, neighbour.m_vPos) >= overlap * overlap)
+					continue;
+
+				m_aCluster.Insert(neighbour);
+				m_aCandidates.Remove(candidateIdx);
+			}
+		}
+
+		int count = m_aCluster.Count();
+		if (count < m_iMinClusterSize)
+			return;
+
+		vector center;
+		vector normal;
+		float paintedArea;
+		float maxExpiryMs;
+		foreach (SCR_SprayPositionEntry clustered : m_aCluster)
+		{
+			center = center + clustered.m_vPos;
+			normal = normal + clustered.m_vNormal;
+			paintedArea += clustered.m_fSize * clustered.m_fSize;
+			if (clustered.m_fExpiryMs > maxExpiryMs)
+				maxExpiryMs = clustered.m_fExpiryMs;
+		}
+
+		center = center * (1.0 / count);
+		normal.Normalize();
+
+		// Every member lies within maxRadius of the seed, so the seed-centred circle always fits
+		float radius = GetBoundingRadius(center);
+		if (radius > maxRadius)
+		{
+			center = seed.m_vPos;
+			radius = GetBoundingRadius(center);
+		}
+
+		// Sparse scatter would turn into one big blot — only merge what is already mostly covered.
+		// Overlaps count twice in paintedArea, which is fine for dense fills.
+		float mergedSize = radius * 2;
+		if (paintedArea < mergedSize * mergedSize * m_fMinCoverage)
+			return;
+
+		float lifetime = (maxExpiryMs - world.GetWorldTime()) / 1000;
+		if (lifetime < MIN_MERGED_LIFETIME)
+			return;
+
+		// The merged decal paints over its whole footprint: more of the same paint joins the
+		// cluster, anything else cancels the merge
+		grid.Query(center, radius + maxRadius, m_aCandidates);
+		foreach (SCR_SprayPositionEntry other : m_aCandidates)
+		{
+			if (m_aCluster.Find(other) != -1)
+				continue;
+
+			float reach = radius + other.m_fSize * 0.5;
+			if (vector.DistanceSq(center, other.m_vPos) >= reach * reach)
+				continue;
+
+			if (!IsLive(other))
+				continue;
+
+			if (!IsSamePaint(seed, other) || other.m_fSize > mergedSize)
+				return;
+
+			m_aCluster.Insert(other);
+		}
+
+		// Registering the merged decal covers or evicts members, which must not drop their saved tags
+		m_aClusterRecords.Clear();
+		foreach (SCR_SprayPositionEntry member : m_aCluster)
+		{
+			m_aClusterRecords.Insert(member.m_aLayerRecords);
+			member.m_aLayerRecords = null;
+		}
+
+		// Paint the merged decal first: if it can't be placed the cluster stays as it is
+		SCR_SprayPositionEntry merged = SCR_SprayProjectile.PlaceMergedDecal(world, seed, center, normal, mergedSize, lifetime);
+
+		int removed = m_aCluster.Count();
+		for (int i = 0; i < removed; i++)
+		{
+			if (merged)
+				SCR_SprayGraffitiLayerComponent.AdoptRecords(merged, m_aClusterRecords[i]);
+			else
+				m_aCluster[i].m_aLayerRecords = m_aClusterRecords[i];
+		}
+
+		m_aClusterRecords.Clear();
+		if (!merged)
+			return;
+
+		foreach (SCR_SprayPositionEntry replaced : m_aCluster)
+		{
+			SCR_SprayProjectile.RemoveTrackedDecal(world, replaced);
+		}
+
+		m_iMergedClusters++;
+		m_iRemovedDecals += removed - 1;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected float GetBoundingRadius(vector center)
+	{
+		float radius;
+		foreach (SCR_SprayPositionEntry member : m_aCluster)
+		{
+			float reach = vector.Distance(center, member.m_vPos) + member.m_fSize * 0.5;
+			if (reach > radius)
+				radius = reach;
+		}
+
+		return radius;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected bool IsLive(SCR_SprayPositionEntry entry)
+	{
+		return entry && !entry.m_bRemoved && !entry.m_bBudgetReleased && entry.m_decal && entry.m_Anchor;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Same anchor, paint, color, owner and surface plane as the seed
+	protected bool IsSamePaint(SCR_SprayPositionEntry seed, SCR_SprayPositionEntry other)
+	{
+		if (!other.m_bCompactable || other.m_Anchor != seed.m_Anchor || other.m_iPlayerId != seed.m_iPlayerId)
+			return false;
+
+		if (other.m_sMaterial != seed.m_sMaterial || other.m_fOpacity != seed.m_fOpacity || other.m_fBrightness != seed.m_fBrightness)
+			return false;
+
+		if (vector.Dot(seed.m_vNormal, other.m_vNormal) < NORMAL_MATCH_COS)
+			return false;
+
+		return Math.AbsFloat(vector.Dot(other.m_vPos - seed.m_vPos, seed.m_vNormal)) <= PLANE_TOLERANCE;
+	}
+}
@@ -0,0 +1,211 @@
+//------------------------------------------------------------------------------------------------
+//! Uniform spatial hash over live spray decal positions.
+//! Entries are bucketed by planar (x, z) cell so spacing and cover checks only touch the cells
+//! around the query, and a min-heap keyed on expiry time lets purging pop just the entries that
+//! have run out. Height is left to the exact distance test — paint stacked up a wall shares a column.
+class SCR_SprayDecalGrid
+{
+	//! Fallback until a can reports its presets; the first can replaces it outright
+	protected float m_fCellSize = 0.5;
+	protected float m_fInvCellSize = 2.0;
+	protected bool m_bCellSizeSet;
+	protected int m_iCount;
+	protected int m_iQueryStamp;
+
+	protected ref map<int, ref array<ref SCR_SprayPositionEntry>> m_mCells = new map<int, ref array<ref SCR_SprayPositionEntry>>();
+	protected ref array<ref SCR_SprayPositionEntry> m_aExpiryHeap = new array<ref SCR_SprayPositionEntry>();
+
+	//------------------------------------------------------------------------------------------------
+	float GetCellSize()
+	{
+		return m_fCellSize;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	int Count()
+	{
+		return m_iCount;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Sizes cells to the largest preset spacing and re-buckets existing entries.
+	//! The first call sets the size as given; later ones only grow it, so several cans with
+	//! different presets all stay covered.
+	void EnsureCellSize(float cellSize)
+	{
+		if (cellSize <= 0 || (m_bCellSizeSet && cellSize <= m_fCellSize))
+			return;
+
+		m_bCellSizeSet = true;
+		m_fCellSize = cellSize;
+		m_fInvCellSize = 1.0 / cellSize;
+
+		array<ref SCR_SprayPositionEntry> entries = new array<ref SCR_SprayPositionEntry>();
+		foreach (int key, array<ref SCR_SprayPositionEntry> bucket : m_mCells)
+		{
+			foreach (SCR_SprayPositionEntry entry : bucket)
+			{
+				entries.Insert(entry);
+			}
+		}
+
+		m_mCells.Clear();
+		foreach (SCR_SprayPositionEntry entry : entries)
+		{
+			AddToBucket(entry);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	void Insert(notnull SCR_SprayPositionEntry entry)
+	{
+		entry.m_bRemoved = false;
+		AddToBucket(entry);
+		HeapPush(entry);
+		m_iCount++;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Removes the entry from its bucket. The heap slot is dropped lazily when it reaches the top.
+	void Remove(notnull SCR_SprayPositionEntry entry)
+	{
+		if (entry.m_bRemoved)
+			return;
+
+		entry.m_bRemoved = true;
+		m_iCount--;
+
+		array<ref SCR_SprayPositionEntry> bucket = m_mCells.Get(entry.m_iCellKey);
+		if (!bucket)
+			return;
+
+		int idx = bucket.Find(entry);
+		if (idx != -1)
+			bucket.Remove(idx);
+
+		if (bucket.IsEmpty())
+			m_mCells.Remove(entry.m_iCellKey);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Pops every entry whose expiry is at or before currentTimeMs. Amortised O(log n) per entry.
+	void PurgeExpired(float currentTimeMs)
+	{
+		while (!m_aExpiryHeap.IsEmpty() && m_aExpiryHeap[0].m_fExpiryMs <= currentTimeMs)
+		{
+			SCR_SprayPositionEntry top = HeapPop();
+			Remove(top);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Collects live entries whose cells overlap the sphere (pos, radius) into outEntries.
+	//! Callers still do the exact distance test; this only narrows the candidate set.
+	void Query(vector pos, float radius, notnull array<SCR_SprayPositionEntry> outEntries)
+	{
+		outEntries.Clear();
+		if (m_iCount <= 0)
+			return;
+
+		// Only the cells the query square actually overlaps — (2·reach)² at most, not a cube.
+		int minX = Math.Floor((pos[0] - radius) * m_fInvCellSize);
+		int maxX = Math.Floor((pos[0] + radius) * m_fInvCellSize);
+		int minZ = Math.Floor((pos[2] - radius) * m_fInvCellSize);
+		int maxZ = Math.Floor((pos[2] + radius) * m_fInvCellSize);
+
+		// Keys wrap every 65536 cells, so a bucket can in principle be reached twice — the stamp
+		// marks entries already collected by this query.
+		m_iQueryStamp++;
+
+		for (int x = minX; x <= maxX; x++)
+		{
+			for (int z = minZ; z <= maxZ; z++)
+			{
+				array<ref SCR_SprayPositionEntry> bucket = m_mCells.Get(CellKey(x, z));
+				if (!bucket)
+					continue;
+
+				foreach (SCR_SprayPositionEntry entry : bucket)
+				{
+					if (entry.m_iQueryStamp == m_iQueryStamp)
+						continue;
+
+					entry.m_iQueryStamp = m_iQueryStamp;
+					outEntries.Insert(entry);
+				}
+			}
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void AddToBucket(SCR_SprayPositionEntry entry)
+	{
+		int key = CellKey(Math.Floor(entry.m_vPos[0] * m_fInvCellSize), Math.Floor(entry.m_vPos[2] * m_fInvCellSize));
+		entry.m_iCellKey = key;
+
+		array<ref SCR_SprayPositionEntry> bucket = m_mCells.Get(key);
+		if (!bucket)
+		{
+			bucket = new array<ref SCR_SprayPositionEntry>();
+			m_mCells.Insert(key, bucket);
+		}
+
+		bucket.Insert(entry);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! 16 bits per axis, packed — distinct for every cell within 65536 cells of each other.
+	protected int CellKey(int x, int z)
+	{
+		return ((x & 0xFFFF) << 16) | (z & 0xFFFF);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void HeapPush(SCR_SprayPositionEntry entry)
+	{
+		m_aExpiryHeap.Insert(entry);
+
+		int i = m_aExpiryHeap.Count() - 1;
+		while (i > 0)
+		{
+			int parent = (i - 1) / 2;
+			if (m_aExpiryHeap[parent].m_fExpiryMs <= m_aExpiryHeap[i].m_fExpiryMs)
+				break;
+
+			m_aExpiryHeap.SwapItems(parent, i);
+			i = parent;
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected SCR_SprayPositionEntry HeapPop()
+	{
+		SCR_SprayPositionEntry top = m_aExpiryHeap[0];
+
+		int last = m_aExpiryHeap.Count() - 1;
+		m_aExpiryHeap.SwapItems(0, last);
+		m_aExpiryHeap.Remove(last);
+
+		int count = m_aExpiryHeap.Count();
+		int i = 0;
+		while (true)
+		{
+			int left = i * 2 + 1;
+			if (left >= count)
+				break;
+
+			int smallest = left;
+			int right = left + 1;
+			if (right < count && m_aExpiryHeap[right].m_fExpiryMs < m_aExpiryHeap[left].m_fExpiryMs)
+				smallest = right;
+
+			if (m_aExpiryHeap[i].m_fExpiryMs <= m_aExpiryHeap[smallest].m_fExpiryMs)
+				break;
+
+			m_aExpiryHeap.SwapItems(i, smallest);
+			i = smallest;
+		}
+
+		return top;
+	}
+}
@@ -0,0 +1,889 @@
+//------------------------------------------------------------------------------------------------
+//! One persisted decal. Position and directions are local to the anchor entity, which is found again
+//! after a restart by its origin. Terrain-anchored records store world space instead.
+class SCR_SprayGraffitiRecord
+{
+	static const int FLAG_WORLD_ANCHOR = 1;
+	static const int FLAG_RANDOM_ROTATION = 2;
+	static const int FLAG_STROKE = 4;
+
+	int m_iMaterialIndex;
+	int m_iFlags;
+	vector m_vAnchorOrigin;
+	vector m_vLocalPos;
+	vector m_vLocalNormal;
+	vector m_vLocalStrokeDir;
+	float m_fSize;
+	float m_fStretch = 1.0;
+	float m_fAngleDeg;
+	int m_iAlpha = 255;
+	int m_iBrightness = 255;
+
+	// Unix time the decal fades. World time restarts with the server, so expiry is stored in wall-clock time.
+	int m_iExpiresAt;
+
+	// Session only: when the server captured it (-1 when loaded from disk), whether it left the world and the region holding it
+	float m_fCapturedAtMs = -1;
+	bool m_bRemoved;
+	SCR_SprayGraffitiRegion m_Region;
+
+	//------------------------------------------------------------------------------------------------
+	int PackHeader()
+	{
+		return (m_iMaterialIndex << 8) | (m_iFlags & 0xFF);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	void UnpackHeader(int packed)
+	{
+		m_iMaterialIndex = (packed >> 8) & 0xFFFFFF;
+		m_iFlags = packed & 0xFF;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Octahedral normal (16) | octahedral stroke direction (16)
+	int PackDirections()
+	{
+		int stroke;
+		if (m_iFlags & FLAG_STROKE)
+			stroke = SCR_SprayRecordCodec.EncodeOctahedral(m_vLocalStrokeDir);
+
+		return (SCR_SprayRecordCodec.EncodeOctahedral(m_vLocalNormal) << 16) | stroke;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	void UnpackDirections(int packed)
+	{
+		m_vLocalNormal = SCR_SprayRecordCodec.DecodeOctahedral((packed >> 16) & 0xFFFF);
+
+		if (m_iFlags & FLAG_STROKE)
+			m_vLocalStrokeDir = SCR_SprayRecordCodec.DecodeOctahedral(packed & 0xFFFF);
+		else
+			m_vLocalStrokeDir = vector.Zero;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Alpha (8) | brightness (8) | stretch (8) | angle (8)
+	int PackAppearance()
+	{
+		return (Math.ClampInt(m_iAlpha, 0, 255) << 24) | (Math.ClampInt(m_iBrightness, 0, 255) << 16)
+			| (SCR_SprayRecordCodec.QuantizeStretch(m_fStretch) << 8) | SCR_SprayRecordCodec.QuantizeAngle(m_fAngleDeg);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	void UnpackAppearance(int packed)
+	{
+		m_iAlpha = (packed >> 24) & 0xFF;
+		m_iBrightness = (packed >> 16) & 0xFF;
+		m_fStretch = SCR_SprayRecordCodec.DequantizeStretch((packed >> 8) & 0xFF);
+		m_fAngleDeg = SCR_SprayRecordCodec.DequantizeAngle(packed & 0xFF);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! 44 bytes: header, anchor origin, local position, directions, appearance, size, expiry
+	void Write(FileHandle file)
+	{
+		int header = PackHeader();
+		int directions = PackDirections();
+		int appearance = PackAppearance();
+		float size = m_fSize;
+		int expiresAt = m_iExpiresAt;
+
+		file.Write(header, 4);
+		WriteVector(file, m_vAnchorOrigin);
+		WriteVector(file, m_vLocalPos);
+		file.Write(directions, 4);
+		file.Write(appearance, 4);
+		file.Write(size, 4);
+		file.Write(expiresAt, 4);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Version 1 records have no expiry; m_iExpiresAt is left for the caller to fill in
+	bool Read(FileHandle file, int version)
+	{
+		int header;
+		if (file.Read(header, 4) != 4)
+			return false;
+
+		UnpackHeader(header);
+
+		if (!ReadVector(file, m_vAnchorOrigin) || !ReadVector(file, m_vLocalPos))
+			return false;
+
+		int directions;
+		int appearance;
+		float size;
+		if (file.Read(directions, 4) != 4 || file.Read(appearance, 4) != 4 || file.Read(size, 4) != 4)
+			return false;
+
+		UnpackDirections(directions);
+		UnpackAppearance(appearance);
+		m_fSize = size;
+
+		if (version < 2)
+			return true;
+
+		int expiresAt;
+		if (file.Read(expiresAt, 4) != 4)
+			return false;
+
+		m_iExpiresAt = expiresAt;
+		return true;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected static void WriteVector(FileHandle file, vector value)
+	{
+		float x = value[0];
+		float y = value[1];
+		float z = value[2];
+		file.Write(x, 4);
+		file.Write(y, 4);
+		file.Write(z, 4);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected static bool ReadVector(FileHandle file, out vector value)
+	{
+		float x;
+		float y;
+		float z;
+		if (file.Read(x, 4) != 4 || file.Read(y, 4) != 4 || file.Read(z, 4) != 4)
+			return false;
+
+		value = Vector(x, y, z);
+		return true;
+	}
+}
+
+//------------------------------------------------------------------------------------------------
+//! Persisted records of one square map region, stored in their own file. Records sit in a ring of
+//! m_iCapacity slots: once it is full each new record overwrites the oldest one.
+//! Removed and expired records keep their slot until the region is next saved.
+class SCR_SprayGraffitiRegion
+{
+	int m_iX;
+	int m_iZ;
+	bool m_bDirty;
+	int m_iCapacity;
+	ref array<ref SCR_SprayGraffitiRecord> m_aRecords = new array<ref SCR_SprayGraffitiRecord>();
+
+	// Oldest slot once the ring is full
+	protected int m_iNext;
+
+	//------------------------------------------------------------------------------------------------
+	void Add(notnull SCR_SprayGraffitiRecord record)
+	{
+		record.m_Region = this;
+		m_bDirty = true;
+
+		if (m_iCapacity <= 0 || m_aRecords.Count() < m_iCapacity)
+		{
+			m_aRecords.Insert(record);
+			return;
+		}
+
+		m_aRecords[m_iNext] = record;
+		m_iNext = (m_iNext + 1) % m_iCapacity;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	void Remove(notnull SCR_SprayGraffitiRecord record)
+	{
+		if (record.m_bRemoved)
+			return;
+
+		record.m_bRemoved = true;
+		m_bDirty = true;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Live records oldest first. Records expired by now are removed on the way.
+	void CollectLive(int now, notnull array<SCR_SprayGraffitiRecord> outRecords)
+	{
+		outRecords.Clear();
+
+		int count = m_aRecords.Count();
+		for (int i = 0; i < count; i++)
+		{
+			SCR_SprayGraffitiRecord record = m_aRecords[(m_iNext + i) % count];
+			if (!record.m_bRemoved && record.m_iExpiresAt <= now)
+				Remove(record);
+
+			if (!record.m_bRemoved)
+				outRecords.Insert(record);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Drops the slots of removed records, keeping the live ones oldest first
+	void Compact(notnull array<SCR_SprayGraffitiRecord> live)
+	{
+		if (live.Count() == m_aRecords.Count())
+			return;
+
+		array<ref SCR_SprayGraffitiRecord> compacted = new array<ref SCR_SprayGraffitiRecord>();
+		foreach (SCR_SprayGraffitiRecord record : live)
+		{
+			compacted.Insert(record);
+		}
+
+		m_aRecords = compacted;
+		m_iNext = 0;
+	}
+}
+
+//------------------------------------------------------------------------------------------------
+[ComponentEditorProps(category: "GameScripted", description: "Persists spray decals to $profile: and restores them per map region as players approach. Add to the game mode entity.")]
+class SCR_SprayGraffitiLayerComponentClass : ScriptComponentClass {}
+
+//! Server-side graffiti layer. Decals arriving through the spray cans' replicated batches are stored per
+//! region in $profile:<dir>/<world>/<x>_<z>.bin (material paths in materials.txt next to them).
+//! Each record is linked to the server's tracked entry of its decal, so eviction, cover and expiry
+//! remove it from the layer like they remove the decal from the world.
+//! Nothing is read at startup: a region file is loaded the first time a player comes within
+//! m_fLoadRadius, and its records are then sent to each client that comes near it.
+class SCR_SprayGraffitiLayerComponent : ScriptComponent
+{
+	[Attribute("1", UIWidgets.CheckBox, "Save spray decals and restore them after a restart")]
+	protected bool m_bEnabled;
+
+	[Attribute("$profile:SprayGraffiti", UIWidgets.EditBox, "Directory for the saved layer. A subfolder per world is created inside it.")]
+	protected string m_sSaveDirectory;
+
+	[Attribute("128", UIWidgets.Slider, "Region size in meters. Each region is one file and is loaded as a whole.", "32 512 16")]
+	protected float m_fRegionSize;
+
+	[Attribute("150", UIWidgets.Slider, "Regions within this distance of a player are loaded and sent", "50 1000 10")]
+	protected float m_fLoadRadius;
+
+	[Attribute("2", UIWidgets.Slider, "Seconds between player proximity checks", "0.5 10 0.5")]
+	protected float m_fCheckInterval;
+
+	[Attribute("120", UIWidgets.Slider, "Seconds between saves of changed regions", "10 600 10")]
+	protected float m_fSaveInterval;
+
+	[Attribute("600", UIWidgets.EditBox, "Decals with a shorter lifetime in seconds are not saved")]
+	protected float m_fMinSavedLifetime;
+
+	[Attribute("2000", UIWidgets.EditBox, "Max saved decals per region. The oldest are dropped first.")]
+	protected int m_iMaxRecordsPerRegion;
+
+	[Attribute("64", UIWidgets.Slider, "Records per region RPC", "8 256 8")]
+	protected int m_iRecordsPerChunk;
+
+	protected static const int FILE_MAGIC = 0x5350474C; // "SPGL"
+	protected static const int FILE_VERSION = 2;
+
+	// Version 1 files carry no expiry; their records get the lifetime restored decals used to have
+	protected static const int LEGACY_LIFETIME = 86400;
+
+	protected static SCR_SprayGraffitiLayerComponent s_Instance;
+
+	protected string m_sLayerPath;
+	protected bool m_bServerRunning;
+	protected bool m_bMaterialsDirty;
+
+	protected ref map<int, ref SCR_SprayGraffitiRegion> m_mRegions = new map<int, ref SCR_SprayGraffitiRegion>();
+	protected ref array<ResourceName> m_aMaterials = new array<ResourceName>();
+	protected ref map<string, int> m_mMaterialIndices = new map<string, int>();
+
+	// Regions already sent to each player, and when the player was first seen: anything captured
+	// after that reached them live through the decal batches
+	protected ref map<int, ref set<int>> m_mPlayerRegions = new map<int, ref set<int>>();
+	protected ref map<int, float> m_mPlayerSeenAtMs = new map<int, float>();
+
+	protected ref array<int> m_aPlayerIds = new array<int>();
+	protected ref array<int> m_aNearbyRegions = new array<int>();
+	protected ref array<SCR_SprayGraffitiRecord> m_aLiveRecords = new array<SCR_SprayGraffitiRecord>();
+	protected ref SCR_SprayDecalRecord m_RestoreRecord = new SCR_SprayDecalRecord();
+	protected ref SCR_SprayGraffitiRecord m_UnpackRecord = new SCR_SprayGraffitiRecord();
+
+	protected vector m_vAnchorSearch;
+	protected IEntity m_AnchorResult;
+
+	//------------------------------------------------------------------------------------------------
+	//! Layer on the current game mode, null if the mode doesn't have one
+	static SCR_SprayGraffitiLayerComponent GetInstance()
+	{
+		return s_Instance;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Drops the saved records of a decal that left the world (evicted or painted over)
+	static void ReleaseRecords(notnull SCR_SprayPositionEntry entry)
+	{
+		if (!entry.m_aLayerRecords)
+			return;
+
+		foreach (SCR_SprayGraffitiRecord record : entry.m_aLayerRecords)
+		{
+			if (record && record.m_Region)
+				record.m_Region.Remove(record);
+		}
+
+		entry.m_aLayerRecords = null;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Hands the saved records of merged decals over to the decal that replaces them
+	static void AdoptRecords(notnull SCR_SprayPositionEntry entry, array<SCR_SprayGraffitiRecord> records)
+	{
+		if (!records)
+			return;
+
+		if (!entry.m_aLayerRecords)
+			entry.m_aLayerRecords = new array<SCR_SprayGraffitiRecord>();
+
+		foreach (SCR_SprayGraffitiRecord record : records)
+		{
+			entry.m_aLayerRecords.Insert(record);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	override protected void OnPostInit(IEntity owner)
+	{
+		super.OnPostInit(owner);
+
+		if (!GetGame().InPlayMode())
+			return;
+
+		s_Instance = this;
+
+		// Replication role is only known once the world is up
+		if (m_bEnabled)
+			GetGame().GetCallqueue().CallLater(StartServer, 0, false);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void StartServer()
+	{
+		if (!Replication.IsServer())
+			return;
+
+		string worldName = FilePath.StripExtension(FilePath.StripPath(GetGame().GetWorldFile()));
+		m_sLayerPath = m_sSaveDirectory + "/" + worldName;
+
+		if (!FileIO.FileExists(m_sLayerPath) && !FileIO.MakeDirectory(m_sLayerPath))
+		{
+			// MakeDirectory does not create parents
+			FileIO.MakeDirectory(m_sSaveDirectory);
+			if (!FileIO.MakeDirectory(m_sLayerPath))
+			{
+				Print(string.Format("[SprayGraffitiLayer] Cannot create '%1' - layer disabled", m_sLayerPath), LogLevel.ERROR);
+				return;
+			}
+		}
+
+		LoadMaterials();
+		m_bServerRunning = true;
+
+		GetGame().GetCallqueue().CallLater(UpdateRegions, m_fCheckInterval * 1000, true);
+		GetGame().GetCallqueue().CallLater(SaveDirty, m_fSaveInterval * 1000, true);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Called on the server for every decal it tracks from a spray can, painted by the host or rebuilt
+	//! from a replicated batch. entry is the server's tracked decal the record lives and dies with.
+	void CaptureDecal(SCR_SprayDecalRecord decal, ResourceName material, float decalSize, float opacity, float brightness, float lifetime, notnull SCR_SprayPositionEntry entry)
+	{
+		if (!m_bServerRunning || lifetime < m_fMinSavedLifetime)
+			return;
+
+		IEntity anchor = entry.m_Anchor;
+		if (!anchor)
+			return;
+
+		SCR_SprayGraffitiRecord record = new SCR_SprayGraffitiRecord();
+		record.m_iMaterialIndex = GetMaterialIndex(material);
+		record.m_fSize = decalSize;
+		record.m_fStretch = decal.m_fStretch;
+		record.m_fAngleDeg = decal.m_fAngleDeg;
+		record.m_iAlpha = opacity * 255;
+		record.m_iBrightness = brightness * 255;
+		record.m_iExpiresAt = System.GetUnixTime() + lifetime;
+		record.m_fCapturedAtMs = GetOwner().GetWorld().GetWorldTime();
+
+		if (decal.m_bRandomRotation)
+			record.m_iFlags |= SCR_SprayGraffitiRecord.FLAG_RANDOM_ROTATION;
+
+		if (decal.m_vStrokeDir != vector.Zero)
+			record.m_iFlags |= SCR_SprayGraffitiRecord.FLAG_STROKE;
+
+		if (GenericTerrainEntity.Cast(anchor))
+		{
+			record.m_iFlags |= SCR_SprayGraffitiRecord.FLAG_WORLD_ANCHOR;
+			record.m_vLocalPos = decal.m_vPos;
+			record.m_vLocalNormal = decal.m_vNormal;
+			record.m_vLocalStrokeDir = decal.m_vStrokeDir;
+		}
+		else
+		{
+			// Vehicles and other moving objects won't be where they were after a restart
+			Physics physics = anchor.GetPhysics();
+			if (physics && physics.IsDynamic())
+				return;
+
+			record.m_vAnchorOrigin = anchor.GetOrigin();
+			record.m_vLocalPos = anchor.CoordToLocal(decal.m_vPos);
+			record.m_vLocalNormal = anchor.VectorToLocal(decal.m_vNormal);
+			record.m_vLocalStrokeDir = anchor.VectorToLocal(decal.m_vStrokeDir);
+		}
+
+		// Loading the region restores its saved decals, which may already paint over this one
+		SCR_SprayGraffitiRegion region = EnsureRegion(RegionCoord(decal.m_vPos[0]), RegionCoord(decal.m_vPos[2]));
+		if (entry.m_bBudgetReleased)
+			return;
+
+		region.Add(record);
+		LinkRecord(entry, record);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void LinkRecord(SCR_SprayPositionEntry entry, SCR_SprayGraffitiRecord record)
+	{
+		if (!entry.m_aLayerRecords)
+			entry.m_aLayerRecords = new array<SCR_SprayGraffitiRecord>();
+
+		entry.m_aLayerRecords.Insert(record);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Loads regions that came within range of a player and sends each one once to that player
+	protected void UpdateRegions()
+	{
+		PlayerManager playerManager = GetGame().GetPlayerManager();
+		playerManager.GetPlayers(m_aPlayerIds);
+
+		// Players who left get a fresh set if they come back
+		array<int> departed = new array<int>();
+		foreach (int knownId, set<int> knownRegions : m_mPlayerRegions)
+		{
+			if (!m_aPlayerIds.Contains(knownId))
+				departed.Insert(knownId);
+		}
+
+		foreach (int departedId : departed)
+		{
+			m_mPlayerRegions.Remove(departedId);
+			m_mPlayerSeenAtMs.Remove(departedId);
+		}
+
+		float now = GetOwner().GetWorld().GetWorldTime();
+		foreach (int playerId : m_aPlayerIds)
+		{
+			IEntity controlled = playerManager.GetPlayerControlledEntity(playerId);
+			if (!controlled)
+				continue;
+
+			set<int> sent = m_mPlayerRegions.Get(playerId);
+			if (!sent)
+			{
+				sent = new set<int>();
+				m_mPlayerRegions.Insert(playerId, sent);
+				m_mPlayerSeenAtMs.Insert(playerId, now);
+			}
+
+			CollectRegionsAround(controlled.GetOrigin(), m_aNearbyRegions);
+			foreach (int key : m_aNearbyRegions)
+			{
+				if (sent.Contains(key))
+					continue;
+
+				sent.Insert(key);
+				SendRegion(playerId, EnsureRegion(RegionKeyX(key), RegionKeyZ(key)));
+			}
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Sends a region's live records to one player in chunks, through their own player controller
+	protected void SendRegion(int playerId, SCR_SprayGraffitiRegion region)
+	{
+		// The server already restored the region for a listen-server host when it loaded it
+		SCR_PlayerController controller = SCR_PlayerController.Cast(GetGame().GetPlayerManager().GetPlayerController(playerId));
+		if (!controller || controller == GetGame().GetPlayerController())
+			return;
+
+		int now = System.GetUnixTime();
+		float seenAtMs = m_mPlayerSeenAtMs.Get(playerId);
+		region.CollectLive(now, m_aLiveRecords);
+
+		array<string> materials = new array<string>();
+		map<int, int> chunkMaterials = new map<int, int>();
+		array<int> ints = new array<int>();
+		array<float> floats = new array<float>();
+
+		int total = m_aLiveRecords.Count();
+		for (int i = 0; i < total; i++)
+		{
+			SCR_SprayGraffitiRecord record = m_aLiveRecords[i];
+
+			// Anything captured after the player was first seen reached them live through the batches
+			if (record.m_fCapturedAtMs < seenAtMs)
+			{
+				// Chunks carry their own small material table; indices are remapped into it
+				int local;
+				if (!chunkMaterials.Find(record.m_iMaterialIndex, local))
+				{
+					local = materials.Insert(m_aMaterials[record.m_iMaterialIndex]);
+					chunkMaterials.Insert(record.m_iMaterialIndex, local);
+				}
+
+				ints.Insert((local << 8) | (record.m_iFlags & 0xFF));
+				ints.Insert(record.PackDirections());
+				ints.Insert(record.PackAppearance());
+
+				floats.Insert(record.m_vAnchorOrigin[0]);
+				floats.Insert(record.m_vAnchorOrigin[1]);
+				floats.Insert(record.m_vAnchorOrigin[2]);
+				floats.Insert(record.m_vLocalPos[0]);
+				floats.Insert(record.m_vLocalPos[1]);
+				floats.Insert(record.m_vLocalPos[2]);
+				floats.Insert(record.m_fSize);
+				floats.Insert(record.m_iExpiresAt - now);
+			}
+
+			if (ints.IsEmpty() || (ints.Count() / 3 < m_iRecordsPerChunk && i + 1 < total))
+				continue;
+
+			controller.SendSprayGraffitiChunk(materials, ints, floats);
+
+			materials = new array<string>();
+			chunkMaterials.Clear();
+			ints = new array<int>();
+			floats = new array<float>();
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Client side: rebuilds one chunk of a region received through SCR_PlayerController
+	void ApplyChunk(array<string> materials, array<int> ints, array<float> floats)
+	{
+		if (!materials || !ints || !floats)
+			return;
+
+		World world = GetOwner().GetWorld();
+		int count = Math.Min(ints.Count() / 3, floats.Count() / 8);
+		for (int i = 0; i < count; i++)
+		{
+			m_UnpackRecord.UnpackHeader(ints[i * 3]);
+			m_UnpackRecord.UnpackDirections(ints[i * 3 + 1]);
+			m_UnpackRecord.UnpackAppearance(ints[i * 3 + 2]);
+
+			int f = i * 8;
+			m_UnpackRecord.m_vAnchorOrigin = Vector(floats[f], floats[f + 1], floats[f + 2]);
+			m_UnpackRecord.m_vLocalPos = Vector(floats[f + 3], floats[f + 4], floats[f + 5]);
+			m_UnpackRecord.m_fSize = floats[f + 6];
+
+			if (m_UnpackRecord.m_iMaterialIndex < materials.Count())
+				RestoreRecord(world, m_UnpackRecord, materials[m_UnpackRecord.m_iMaterialIndex], floats[f + 7]);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Recreates the decal of a record for its remaining lifetime. Returns its tracked entry.
+	protected SCR_SprayPositionEntry RestoreRecord(World world, SCR_SprayGraffitiRecord record, ResourceName material, float lifetime)
+	{
+		if (lifetime <= 0)
+			return null;
+
+		IEntity anchor;
+		if (record.m_iFlags & SCR_SprayGraffitiRecord.FLAG_WORLD_ANCHOR)
+		{
+			m_RestoreRecord.m_vPos = record.m_vLocalPos;
+			m_RestoreRecord.m_vNormal = record.m_vLocalNormal;
+			m_RestoreRecord.m_vStrokeDir = record.m_vLocalStrokeDir;
+		}
+		else
+		{
+			anchor = FindAnchorByOrigin(world, record.m_vAnchorOrigin);
+			if (!anchor)
+				return null;
+
+			m_RestoreRecord.m_vPos = anchor.CoordToParent(record.m_vLocalPos);
+			m_RestoreRecord.m_vNormal = anchor.VectorToParent(record.m_vLocalNormal);
+			m_RestoreRecord.m_vStrokeDir = anchor.VectorToParent(record.m_vLocalStrokeDir);
+		}
+
+		m_RestoreRecord.m_fStretch = record.m_fStretch;
+		m_RestoreRecord.m_fAngleDeg = record.m_fAngleDeg;
+		m_RestoreRecord.m_bRandomRotation = (record.m_iFlags & SCR_SprayGraffitiRecord.FLAG_RANDOM_ROTATION) != 0;
+
+		return SCR_SprayProjectile.RebuildDecal(world, m_RestoreRecord, material, record.m_fSize,
+			record.m_iAlpha / 255.0, record.m_iBrightness / 255.0, lifetime, 0, anchor);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Static map objects keep their origin across restarts; a destroyed or moved anchor drops the tag
+	protected IEntity FindAnchorByOrigin(World world, vector origin)
+	{
+		m_vAnchorSearch = origin;
+		m_AnchorResult = null;
+		world.QueryEntitiesBySphere(origin, 0.5, AnchorQueryCallback);
+		return m_AnchorResult;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected bool AnchorQueryCallback(IEntity entity)
+	{
+		if (entity.GetParent())
+			return true;
+
+		if (vector.DistanceSq(entity.GetOrigin(), m_vAnchorSearch) > 0.0025)
+			return true;
+
+		m_AnchorResult = entity;
+		return false;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected int RegionCoord(float worldCoord)
+	{
+		return Math.Floor(worldCoord / m_fRegionSize);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected int RegionKey(int x, int z)
+	{
+		return (x << 16) | (z & 0xFFFF);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected int RegionKeyX(int key)
+	{
+		return key >> 16;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Sign-extends the low 16 bits
+	protected int RegionKeyZ(int key)
+	{
+		return (key << 16) >> 16;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void CollectRegionsAround(vector pos, notnull array<int> outKeys)
+	{
+		outKeys.Clear();
+
+		int reach = Math.Ceil(m_fLoadRadius / m_fRegionSize);
+		int cx = RegionCoord(pos[0]);
+		int cz = RegionCoord(pos[2]);
+		for (int x = cx - reach; x <= cx + reach; x++)
+		{
+			for (int z = cz - reach; z <= cz + reach; z++)
+			{
+				outKeys.Insert(RegionKey(x, z));
+			}
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Region from memory, loading its file on first use
+	protected SCR_SprayGraffitiRegion EnsureRegion(int x, int z)
+	{
+		int key = RegionKey(x, z);
+		SCR_SprayGraffitiRegion region = m_mRegions.Get(key);
+		if (region)
+			return region;
+
+		region = new SCR_SprayGraffitiRegion();
+		region.m_iX = x;
+		region.m_iZ = z;
+		region.m_iCapacity = m_iMaxRecordsPerRegion;
+		m_mRegions.Insert(key, region);
+
+		LoadRegion(region);
+		return region;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected string GetRegionPath(SCR_SprayGraffitiRegion region)
+	{
+		return string.Format("%1/%2_%3.bin", m_sLayerPath, region.m_iX, region.m_iZ);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void LoadRegion(SCR_SprayGraffitiRegion region)
+	{
+		string path = GetRegionPath(region);
+		if (!FileIO.FileExists(path))
+			return;
+
+		FileHandle file = FileIO.OpenFile(path, FileMode.READ);
+		if (!file)
+		{
+			Print(string.Format("[SprayGraffitiLayer] Cannot open '%1'", path), LogLevel.WARNING);
+			return;
+		}
+
+		int magic;
+		int version;
+		int count;
+		file.Read(magic, 4);
+		file.Read(version, 4);
+		file.Read(count, 4);
+
+		if (magic != FILE_MAGIC || version < 1 || version > FILE_VERSION)
+		{
+			Print(string.Format("[SprayGraffitiLayer] '%1' is not a version %2 layer file - ignored", path, FILE_VERSION), LogLevel.WARNING);
+			file.Close();
+			return;
+		}
+
+		int now = System.GetUnixTime();
+		for (int i = 0; i < count; i++)
+		{
+			SCR_SprayGraffitiRecord record = new SCR_SprayGraffitiRecord();
+			if (!record.Read(file, version))
+			{
+				Print(string.Format("[SprayGraffitiLayer] '%1' is truncated after %2 records", path, i), LogLevel.WARNING);
+				break;
+			}
+
+			if (version < 2)
+				record.m_iExpiresAt = now + LEGACY_LIFETIME;
+
+			if (record.m_iMaterialIndex < m_aMaterials.Count() && record.m_iExpiresAt > now)
+				region.Add(record);
+		}
+
+		file.Close();
+
+		// Old format files are rewritten on the next save
+		region.m_bDirty = version < FILE_VERSION;
+
+		// The server tracks restored decals like live ones, so their records go when the decals do.
+		// A listen-server host sees them from here on.
+		World world = GetOwner().GetWorld();
+		region.CollectLive(now, m_aLiveRecords);
+		foreach (SCR_SprayGraffitiRecord restored : m_aLiveRecords)
+		{
+			SCR_SprayPositionEntry entry = RestoreRecord(world, restored, m_aMaterials[restored.m_iMaterialIndex], restored.m_iExpiresAt - now);
+			if (entry)
+				LinkRecord(entry, restored);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void SaveRegion(SCR_SprayGraffitiRegion region)
+	{
+		region.CollectLive(System.GetUnixTime(), m_aLiveRecords);
+		region.Compact(m_aLiveRecords);
+
+		string path = GetRegionPath(region);
+		if (m_aLiveRecords.IsEmpty())
+		{
+			if (FileIO.FileExists(path))
+				FileIO.DeleteFile(path);
+
+			region.m_bDirty = false;
+			return;
+		}
+
+		FileHandle file = FileIO.OpenFile(path, FileMode.WRITE);
+		if (!file)
+		{
+			Print(string.Format("[SprayGraffitiLayer] Cannot write '%1'", path), LogLevel.WARNING);
+			return;
+		}
+
+		int magic = FILE_MAGIC;
+		int version = FILE_VERSION;
+		int count = m_aLiveRecords.Count();
+		file.Write(magic, 4);
+		file.Write(version, 4);
+		file.Write(count, 4);
+
+		foreach (SCR_SprayGraffitiRecord record : m_aLiveRecords)
+		{
+			record.Write(file);
+		}
+
+		file.Close();
+		region.m_bDirty = false;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void SaveDirty()
+	{
+		// Region files index into the material table, so it goes first
+		if (m_bMaterialsDirty)
+			SaveMaterials();
+
+		foreach (int key, SCR_SprayGraffitiRegion region : m_mRegions)
+		{
+			if (region.m_bDirty)
+				SaveRegion(region);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected int GetMaterialIndex(ResourceName material)
+	{
+		int index;
+		if (m_mMaterialIndices.Find(material, index))
+			return index;
+
+		index = m_aMaterials.Insert(material);
+		m_mMaterialIndices.Insert(material, index);
+		m_bMaterialsDirty = true;
+		return index;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void LoadMaterials()
+	{
+		string path = m_sLayerPath + "/materials.txt";
+		if (!FileIO.FileExists(path))
+			return;
+
+		FileHandle file = FileIO.OpenFile(path, FileMode.READ);
+		if (!file)
+			return;
+
+		string line;
+		while (file.ReadLine(line) > 0)
+		{
+			int index = m_aMaterials.Insert(line);
+			m_mMaterialIndices.Insert(line, index);
+		}
+
+		file.Close();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void SaveMaterials()
+	{
+		FileHandle file = FileIO.OpenFile(m_sLayerPath + "/materials.txt", FileMode.WRITE);
+		if (!file)
+			return;
+
+		foreach (ResourceName material : m_aMaterials)
+		{
+			file.WriteLine(material);
+		}
+
+		file.Close();
+		m_bMaterialsDirty = false;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	override protected void OnDelete(IEntity owner)
+	{
+		GetGame().GetCallqueue().Remove(StartServer);
+		GetGame().GetCallqueue().Remove(UpdateRegions);
+		GetGame().GetCallqueue().Remove(SaveDirty);
+
+		if (m_bServerRunning)
+			SaveDirty();
+
+		if (s_Instance == this)
+			s_Instance = null;
+
+		super.OnDelete(owner);
+	}
+}
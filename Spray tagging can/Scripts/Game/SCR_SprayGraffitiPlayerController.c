@@ -0,0 +1,21 @@
+//------------------------------------------------------------------------------------------------
+//! Delivers graffiti layer regions to the one client that needs them. The player controller is
+//! owned by its client, so an owner RPC on it reaches only that player.
+modded class SCR_PlayerController
+{
+	//------------------------------------------------------------------------------------------------
+	//! Server side: sends one region chunk built by SCR_SprayGraffitiLayerComponent to this controller's client
+	void SendSprayGraffitiChunk(array<string> materials, array<int> ints, array<float> floats)
+	{
+		Rpc(RpcDo_SprayGraffitiChunk, materials, ints, floats);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	[RplRpc(RplChannel.Reliable, RplRcver.Owner)]
+	protected void RpcDo_SprayGraffitiChunk(array<string> materials, array<int> ints, array<float> floats)
+	{
+		SCR_SprayGraffitiLayerComponent layer = SCR_SprayGraffitiLayerComponent.GetInstance();
+		if (layer)
+			layer.ApplyChunk(materials, ints, floats);
+	}
+}
@@ -4,6 +4,45 @@ class SCR_SprayPositionEntry
 	float m_fExpiryMs;
 	float m_fSize;
 	Decal m_decal;
+	int m_iCellKey;
+	int m_iQueryStamp;
+	bool m_bRemoved;
+	int m_iPlayerId;
+	bool m_bBudgetReleased;
+
+	// Appearance, so SCR_SprayDecalCompactor can tell which decals may merge and repaint them as one
+	IEntity m_Anchor;
+	vector m_vNormal;
+	ResourceName m_sMaterial;
+	float m_fOpacity;
+	float m_fBrightness;
+	bool m_bCompactable;
+
+	// Server only: graffiti layer records this decal keeps alive (several once compaction merged it)
+	ref array<SCR_SprayGraffitiRecord> m_aLayerRecords;
+}
+
+//------------------------------------------------------------------------------------------------
+//! Finds any entity near a hit point that has no TraceEnt (terrain-adjacent geometry)
+class SCR_SprayHitEntityQuery
+{
+	protected IEntity m_Result;
+
+	//------------------------------------------------------------------------------------------------
+	IEntity Find(World world, vector pos)
+	{
+		world.QueryEntitiesBySphere(pos, 1.0, QueryHitEntityCallback);
+		IEntity result = m_Result;
+		m_Result = null;
+		return result;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected bool QueryHitEntityCallback(IEntity entity)
+	{
+		m_Result = entity;
+		return false;
+	}
 }
 
 //------------------------------------------------------------------------------------------------
@@ -18,98 +57,68 @@ class SCR_SprayProjectile : ScriptComponent
 	[Attribute("60", UIWidgets.EditBox, "Decal lifetime in seconds")]
 	protected float m_fDecalLifetime;
 
-	[Attribute("0", UIWidgets.CheckBox, "Enable debug prints")]
-	protected bool m_bDebug;
-
-	protected IEntity m_QueryResult;
+	[Attribute("1500", UIWidgets.EditBox, "Max live spray decals on this machine across all players (0 = unlimited). Oldest decals are removed first.")]
+	protected int m_iGlobalDecalCap;
 
-	// Set by SCR_SpraySizeManagerComponent
-	protected static float s_fDecalSize = 0.3;
-	protected static float s_fMinSpacing = 0.15;
-	protected static ResourceName s_sMaterial;
-	protected static float s_fOpacity = 1.0;
-	protected static float s_fBrightness = 1.0;
-	protected static bool s_bRandomRotation = true;
-	protected static vector s_vPlayerForward = "0 0 1";
-	protected static float s_fPlayerYawDeg = 0;
-	protected static SCR_SpraySizeManagerComponent s_Manager;
+	[Attribute("300", UIWidgets.EditBox, "Max live spray decals per player (0 = unlimited). The player's oldest decals are removed first.")]
+	protected int m_iPlayerDecalQuota;
 
-	protected static ref array<ref SCR_SprayPositionEntry> s_aDecalPositions = new array<ref SCR_SprayPositionEntry>();
-
-	//------------------------------------------------------------------------------------------------
-	static void SetSize(float decalSize, float minSpacing)
-	{
-		s_fDecalSize = decalSize;
-		s_fMinSpacing = minSpacing;
-	}
-
-	//------------------------------------------------------------------------------------------------
-	static void SetMaterial(ResourceName mat)
-	{
-		s_sMaterial = mat;
-	}
-
-	//------------------------------------------------------------------------------------------------
-	static void SetOpacity(float alpha)
-	{
-		s_fOpacity = alpha;
-	}
+	[Attribute("0", UIWidgets.CheckBox, "Enable debug prints")]
+	protected bool m_bDebug;
 
-	//------------------------------------------------------------------------------------------------
-	static void SetBrightness(float brightness)
-	{
-		s_fBrightness = brightness;
-	}
+	protected static ref SCR_SprayHitEntityQuery s_HitQuery = new SCR_SprayHitEntityQuery();
+	protected static ref SCR_SprayDecalGrid s_DecalGrid = new SCR_SprayDecalGrid();
+	protected static ref array<SCR_SprayPositionEntry> s_aQueryResults = new array<SCR_SprayPositionEntry>();
+	protected static ref array<SCR_SprayPositionEntry> s_aEvicted = new array<SCR_SprayPositionEntry>();
+	protected static ref TraceParam s_AnchorTrace = CreateAnchorTrace();
 
-	//------------------------------------------------------------------------------------------------
-	static void SetRandomRotation(bool enabled)
-	{
-		s_bRandomRotation = enabled;
-	}
+	// Set by the can that fired this projectile, and only on the shooter's machine
+	protected IEntity m_SourceWeapon;
 
 	//------------------------------------------------------------------------------------------------
-	static void SetPlayerForward(vector fwd)
+	protected static TraceParam CreateAnchorTrace()
 	{
-		s_vPlayerForward = fwd;
+		TraceParam trace = new TraceParam();
+		trace.Flags = TraceFlags.WORLD | TraceFlags.ENTS;
+		return trace;
 	}
 
 	//------------------------------------------------------------------------------------------------
-	static void SetPlayerYaw(float yawDeg)
+	//! Sizes the spacing grid's cells to the largest spacing any loaded can uses
+	static void EnsureGridCellSize(float cellSize)
 	{
-		s_fPlayerYawDeg = yawDeg;
+		s_DecalGrid.EnsureCellSize(cellSize);
 	}
 
 	//------------------------------------------------------------------------------------------------
-	static float GetPlayerYaw()
+	//! Live decals on this machine, for passes that work on what is already painted
+	static SCR_SprayDecalGrid GetDecalGrid()
 	{
-		return s_fPlayerYawDeg;
+		return s_DecalGrid;
 	}
 
 	//------------------------------------------------------------------------------------------------
-	static void SetManager(SCR_SpraySizeManagerComponent manager)
+	//! Takes a tracked decal out of the world, the spacing grid and the budget
+	static void RemoveTrackedDecal(World world, notnull SCR_SprayPositionEntry entry)
 	{
-		s_Manager = manager;
-	}
+		if (entry.m_decal)
+			world.RemoveDecal(entry.m_decal);
 
-	//------------------------------------------------------------------------------------------------
-	protected bool QueryHitEntityCallback(IEntity entity)
-	{
-		m_QueryResult = entity;
-		return false;
+		entry.m_decal = null;
+		s_DecalGrid.Remove(entry);
+		SCR_SprayDecalBudget.GetInstance().Release(entry);
+		SCR_SprayGraffitiLayerComponent.ReleaseRecords(entry);
 	}
 
 	//------------------------------------------------------------------------------------------------
-	protected void PurgeExpiredPositions(float currentTimeMs)
+	protected static void PurgeExpiredPositions(float currentTimeMs)
 	{
-		for (int i = s_aDecalPositions.Count() - 1; i >= 0; i--)
-		{
-			if (s_aDecalPositions[i].m_fExpiryMs <= currentTimeMs)
-				s_aDecalPositions.Remove(i);
-		}
+		s_DecalGrid.PurgeExpired(currentTimeMs);
+		SCR_SprayDecalBudget.GetInstance().PurgeExpired(currentTimeMs);
 	}
 
 	//------------------------------------------------------------------------------------------------
-	protected bool IsTooClose(vector hitPos, float minSpacing, float newSize)
+	protected static bool IsTooClose(vector hitPos, float minSpacing, float newSize)
 	{
 		if (minSpacing <= 0)
 			return false;
@@ -117,7 +126,8 @@ class SCR_SprayProjectile : ScriptComponent
 		PurgeExpiredPositions(GetGame().GetWorld().GetWorldTime());
 
 		float spacingSq = minSpacing * minSpacing;
-		foreach (SCR_SprayPositionEntry entry : s_aDecalPositions)
+		s_DecalGrid.Query(hitPos, minSpacing, s_aQueryResults);
+		foreach (SCR_SprayPositionEntry entry : s_aQueryResults)
 		{
 			if (vector.DistanceSq(hitPos, entry.m_vPos) < spacingSq)
 			{
@@ -132,92 +142,309 @@ class SCR_SprayProjectile : ScriptComponent
 	}
 
 	//------------------------------------------------------------------------------------------------
-	protected void RemoveSmallerDecals(World world, vector hitPos, float newSize)
+	//! Removes smaller decals whose centre lies under the new one. A stretched decal covers a
+	//! newSize-wide strip of newSize * stretch along strokeDir, not a circle of its long side.
+	protected static void RemoveSmallerDecals(World world, vector hitPos, float newSize, float stretch, vector strokeDir)
 	{
-		float coverRadius = newSize * 0.5;
-		float coverRadiusSq = coverRadius * coverRadius;
+		float halfWidth = newSize * 0.5;
+		float halfLength = halfWidth;
+		if (strokeDir != vector.Zero)
+			halfLength = halfWidth * Math.Max(stretch, 1.0);
 
-		for (int i = s_aDecalPositions.Count() - 1; i >= 0; i--)
+		s_DecalGrid.Query(hitPos, halfLength, s_aQueryResults);
+		foreach (SCR_SprayPositionEntry entry : s_aQueryResults)
 		{
-			SCR_SprayPositionEntry entry = s_aDecalPositions[i];
 			if (entry.m_fSize >= newSize)
 				continue;
 
-			if (vector.DistanceSq(hitPos, entry.m_vPos) < coverRadiusSq)
+			vector offset = entry.m_vPos - hitPos;
+			if (strokeDir == vector.Zero)
 			{
-				if (entry.m_decal)
-					world.RemoveDecal(entry.m_decal);
+				if (offset.LengthSq() < halfWidth * halfWidth)
+					RemoveTrackedDecal(world, entry);
 
-				s_aDecalPositions.Remove(i);
+				continue;
 			}
+
+			float along = vector.Dot(offset, strokeDir);
+			if (Math.AbsFloat(along) >= halfLength)
+				continue;
+
+			vector across = offset - strokeDir * along;
+			if (across.LengthSq() < halfWidth * halfWidth)
+				RemoveTrackedDecal(world, entry);
 		}
 	}
 
 	//------------------------------------------------------------------------------------------------
-	protected void TrackPosition(vector hitPos, float lifetimeSeconds, float size, Decal decal)
+	protected static SCR_SprayPositionEntry TrackPosition(World world, vector hitPos, float lifetimeSeconds, float size, Decal decal, int playerId)
 	{
 		SCR_SprayPositionEntry entry = new SCR_SprayPositionEntry();
 		entry.m_vPos = hitPos;
-		entry.m_fExpiryMs = GetGame().GetWorld().GetWorldTime() + lifetimeSeconds * 1000;
+		entry.m_fExpiryMs = world.GetWorldTime() + lifetimeSeconds * 1000;
 		entry.m_fSize = size;
 		entry.m_decal = decal;
-		s_aDecalPositions.Insert(entry);
+		s_DecalGrid.Insert(entry);
+
+		// Over budget: the least-recently-placed decals were removed from the world, drop them from the grid too
+		SCR_SprayDecalBudget.GetInstance().Register(world, entry, playerId, s_aEvicted);
+		foreach (SCR_SprayPositionEntry evicted : s_aEvicted)
+		{
+			s_DecalGrid.Remove(evicted);
+			SCR_SprayGraffitiLayerComponent.ReleaseRecords(evicted);
+		}
+
+		return entry;
 	}
 
 	//------------------------------------------------------------------------------------------------
-	override protected void OnPostInit(IEntity owner)
+	//! Builds [right, -up, projectionDir, origin] for CreateDecal2 with the stencil "up" as close
+	//! to desiredUp as the surface allows
+	protected static void BuildDecalMatrix(vector surfaceNormal, vector desiredUp, vector origin, out vector decalMat[4])
 	{
-		super.OnPostInit(owner);
-		GetGame().GetCallqueue().CallLater(DoSpray, 0, false, owner);
+		// right = cross(surfaceNormal, desiredUp)  (stencil X-axis)
+		vector right = Vector(
+			surfaceNormal[1] * desiredUp[2] - surfaceNormal[2] * desiredUp[1],
+			surfaceNormal[2] * desiredUp[0] - surfaceNormal[0] * desiredUp[2],
+			surfaceNormal[0] * desiredUp[1] - surfaceNormal[1] * desiredUp[0]
+		);
+		float rLen = right.Length();
+		if (rLen > 0.001)
+			right = right * (1.0 / rLen);
+
+		// Recompute up to ensure orthogonality: up = cross(right, -surfaceNormal)
+		vector up = Vector(
+			right[1] * (-surfaceNormal[2]) - right[2] * (-surfaceNormal[1]),
+			right[2] * (-surfaceNormal[0]) - right[0] * (-surfaceNormal[2]),
+			right[0] * (-surfaceNormal[1]) - right[1] * (-surfaceNormal[0])
+		);
+
+		decalMat[0] = right;
+		decalMat[1] = -up;
+		decalMat[2] = -surfaceNormal;
+		decalMat[3] = origin;
 	}
 
 	//------------------------------------------------------------------------------------------------
-	protected void DoSpray(IEntity owner)
+	//! Creates one decal with the can's color/opacity/orientation settings, removes the smaller
+	//! decals it covers, tracks it for spacing and budget and queues it for replication.
+	//! stretch > 1 elongates the decal along strokeDir (stroke segments); pass vector.Zero otherwise.
+	static SCR_SprayPositionEntry PlaceDecal(notnull SCR_SpraySettings settings, World world, IEntity hitEntity, vector hitPos, vector surfaceNormal, float decalSize, float stretch, vector strokeDir, float lifetime)
 	{
-		if (!owner)
-			return;
+		SCR_SpraySizeManagerComponent manager = settings.m_Manager;
 
-		float decalSize = s_fDecalSize;
-		float minSpacing = s_fMinSpacing;
+		// Random modes roll the angle here so the replicated record carries the same rotation;
+		// stencil modes send the painter's facing, which orients the stencil on floors and ceilings
+		float angleDeg;
+		if (settings.m_bRandomRotation)
+		{
+			angleDeg = Math.RandomFloat(0, 360);
+		}
+		else if (manager)
+		{
+			vector forward = manager.GetHolderForward();
+			angleDeg = Math.Atan2(forward[0], forward[2]) * Math.RAD2DEG;
+		}
 
-		int alpha = Math.ClampInt(s_fOpacity * 255, 0, 255);
-		int bright = Math.ClampInt(s_fBrightness * 255, 0, 255);
-		int decalColor = (alpha << 24) | (bright << 16) | (bright << 8) | bright;
+		int playerId;
+		if (manager)
+			playerId = manager.GetHolderPlayerId();
 
-		vector mat[4];
-		owner.GetWorldTransform(mat);
+		SCR_SprayPositionEntry entry = CreateSprayDecal(world, hitEntity, hitPos, surfaceNormal, decalSize, stretch, strokeDir,
+			settings.m_sMaterial, settings.m_fOpacity, settings.m_fBrightness, settings.m_bRandomRotation, angleDeg, lifetime, playerId);
 
-		vector startPos = mat[3];
-		vector forward = mat[2];
-		vector rayEnd = startPos + forward * m_fMaxRange;
+		if (entry && manager)
+			manager.QueueReplicatedDecal(entry, hitPos, surfaceNormal, stretch, strokeDir, settings.m_bRandomRotation, angleDeg, lifetime);
 
-		World world = owner.GetWorld();
-		if (!world)
+		return entry;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Recreates a decal received from another machine or restored from disk. Without hitEntity the
+	//! anchor is found again with FindDecalAnchor, since entity references are not part of the record.
+	//! Returns the tracked entry, null when there is nothing to attach to.
+	static SCR_SprayPositionEntry RebuildDecal(World world, notnull SCR_SprayDecalRecord record, ResourceName material, float decalSize, float opacity, float brightness, float lifetime, int playerId, IEntity hitEntity = null)
+	{
+		if (!world || !material || material.IsEmpty())
+			return null;
+
+		if (!hitEntity)
+			hitEntity = FindDecalAnchor(world, record.m_vPos, record.m_vNormal);
+
+		if (!hitEntity)
+			return null;
+
+		return CreateSprayDecal(world, hitEntity, record.m_vPos, record.m_vNormal, decalSize, record.m_fStretch, record.m_vStrokeDir,
+			material, opacity, brightness, record.m_bRandomRotation, record.m_fAngleDeg, lifetime, playerId);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Paints one decal that replaces a merged cluster, with the paint of source. Local only — every
+	//! machine compacts its own decals, so nothing is replicated or saved for it.
+	//! Returns the tracked entry, null if the decal could not be painted.
+	static SCR_SprayPositionEntry PlaceMergedDecal(World world, notnull SCR_SprayPositionEntry source, vector pos, vector surfaceNormal, float decalSize, float lifetime)
+	{
+		if (!source.m_Anchor)
+			return null;
+
+		return CreateSprayDecal(world, source.m_Anchor, pos, surfaceNormal, decalSize, 1.0, vector.Zero,
+			source.m_sMaterial, source.m_fOpacity, source.m_fBrightness, true, Math.RandomFloat(0, 360), lifetime, source.m_iPlayerId);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Root entity under a painted point, found with a short trace through the surface
+	static IEntity FindDecalAnchor(World world, vector pos, vector surfaceNormal)
+	{
+		s_AnchorTrace.Start = pos + surfaceNormal * 0.25;
+		s_AnchorTrace.End = pos - surfaceNormal * 0.25;
+		s_AnchorTrace.TraceEnt = null;
+		world.TraceMove(s_AnchorTrace, null);
+
+		IEntity hitEntity = s_AnchorTrace.TraceEnt;
+		if (!hitEntity)
+			hitEntity = s_HitQuery.Find(world, pos);
+
+		if (!hitEntity)
+			return null;
+
+		IEntity parent = hitEntity.GetParent();
+		while (parent)
 		{
-			delete owner;
-			return;
+			hitEntity = parent;
+			parent = hitEntity.GetParent();
 		}
 
-		TraceParam trace = new TraceParam();
-		trace.Start = startPos;
-		trace.End = rayEnd;
-		trace.Flags = TraceFlags.WORLD | TraceFlags.ENTS;
-		trace.Exclude = owner;
+		return hitEntity;
+	}
 
-		float hitFraction = world.TraceMove(trace, null);
+	//------------------------------------------------------------------------------------------------
+	//! Shared by local painting and replicated rebuilds. angleDeg is the decal rotation in random modes
+	//! and the painter's facing yaw otherwise. Dedicated servers don't render: they only track the entry,
+	//! so the graffiti layer sees the same cover, budget and expiry as the clients.
+	protected static SCR_SprayPositionEntry CreateSprayDecal(World world, IEntity hitEntity, vector hitPos, vector surfaceNormal, float decalSize, float stretch, vector strokeDir,
+		ResourceName material, float opacity, float brightness, bool randomRotation, float angleDeg, float lifetime, int playerId)
+	{
+		if (!material || material.IsEmpty())
+			return null;
 
-		if (hitFraction >= 1.0)
+		Decal decal;
+		if (!System.IsConsoleApp())
 		{
-			if (m_bDebug)
-				Print("[SprayProjectile] Miss - nothing hit", LogLevel.NORMAL);
+			// Nothing painted, so nothing is covered or tracked
+			decal = SpawnWorldDecal(world, hitEntity, hitPos, surfaceNormal, decalSize, stretch, strokeDir, material, opacity, brightness, randomRotation, angleDeg, lifetime);
+			if (!decal)
+				return null;
+		}
 
-			delete owner;
-			return;
+		// Entries keep the decal's width as their size, so spacing and cover compare like with like
+		RemoveSmallerDecals(world, hitPos, decalSize, stretch, strokeDir);
+		SCR_SprayPositionEntry entry = TrackPosition(world, hitPos, lifetime, decalSize, decal, playerId);
+
+		entry.m_Anchor = hitEntity;
+		entry.m_vNormal = surfaceNormal;
+		entry.m_sMaterial = material;
+		entry.m_fOpacity = opacity;
+		entry.m_fBrightness = brightness;
+
+		// Only round free-paint blobs can be merged; stencils and stroke segments keep their shape
+		entry.m_bCompactable = decal && randomRotation && strokeDir == vector.Zero && stretch == 1.0;
+		if (entry.m_bCompactable)
+			SCR_SprayDecalCompactor.GetInstance().Enqueue(entry);
+
+		return entry;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected static Decal SpawnWorldDecal(World world, IEntity hitEntity, vector hitPos, vector surfaceNormal, float decalSize, float stretch, vector strokeDir,
+		ResourceName material, float opacity, float brightness, bool randomRotation, float angleDeg, float lifetime)
+	{
+		int alpha = Math.ClampInt(opacity * 255, 0, 255);
+		int bright = Math.ClampInt(brightness * 255, 0, 255);
+		int decalColor = (alpha << 24) | (bright << 16) | (bright << 8) | bright;
+
+		vector decalOrigin = hitPos + surfaceNormal * 0.2;
+
+		Decal decal;
+		if (strokeDir != vector.Zero)
+		{
+			// Stencil X-axis runs along the stroke so the stretch follows the painted line.
+			// desiredUp = cross(strokeDir, surfaceNormal) makes right = strokeDir in BuildDecalMatrix.
+			vector desiredUp = Vector(
+				strokeDir[1] * surfaceNormal[2] - strokeDir[2] * surfaceNormal[1],
+				strokeDir[2] * surfaceNormal[0] - strokeDir[0] * surfaceNormal[2],
+				strokeDir[0] * surfaceNormal[1] - strokeDir[1] * surfaceNormal[0]
+			);
+
+			vector decalMat[4];
+			BuildDecalMatrix(surfaceNormal, desiredUp.Normalized(), decalOrigin, decalMat);
+			decal = world.CreateDecal2(hitEntity, decalMat, 0.0, 1.0, decalSize, stretch, material, lifetime, decalColor);
 		}
+		else if (randomRotation)
+		{
+			decal = world.CreateDecal(hitEntity, decalOrigin, -surfaceNormal, 0.0, 1.0, angleDeg, decalSize, stretch, material, lifetime, decalColor);
+		}
+		else
+		{
+			// Build an explicit orientation matrix so the stencil appears
+			// upright on walls and facing the player on floors/ceilings/objects.
 
-		vector hitPos = startPos + (rayEnd - startPos) * hitFraction;
-		vector surfaceNormal = trace.TraceNorm;
-		IEntity hitEntity = trace.TraceEnt;
+			// Desired "up" for the stencil texture:
+			//   - On walls/angled surfaces: project world-up onto the surface plane
+			//   - On near-horizontal surfaces: project player's forward onto the surface plane
+			vector worldUp = Vector(0, 1, 0);
+			float dotNU = vector.Dot(surfaceNormal, worldUp);
+			vector stencilUp = worldUp - surfaceNormal * dotNU;
+			float desLen = stencilUp.Length();
+
+			if (desLen < 0.15)
+			{
+				// Near-horizontal surface — use player forward as stencil "up"
+				float yawRad = angleDeg * Math.DEG2RAD;
+				vector playerForward = Vector(Math.Sin(yawRad), 0, Math.Cos(yawRad));
+				float dotNF = vector.Dot(surfaceNormal, playerForward);
+				stencilUp = playerForward - surfaceNormal * dotNF;
+				desLen = stencilUp.Length();
+			}
+
+			if (desLen > 0.001)
+				stencilUp = stencilUp * (1.0 / desLen);
+			else
+				stencilUp = Vector(0, 0, 1);
+
+			vector stencilMat[4];
+			BuildDecalMatrix(surfaceNormal, stencilUp, decalOrigin, stencilMat);
+			decal = world.CreateDecal2(hitEntity, stencilMat, 0.0, 1.0, decalSize, stretch, material, lifetime, decalColor);
+		}
+
+		return decal;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! True when the can batches shots into strokes for its current mode
+	static bool IsStrokeActive(notnull SCR_SpraySettings settings)
+	{
+		return settings.m_Manager && settings.m_Manager.IsStrokeModeActive() && settings.m_bRandomRotation;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Stroke mode only samples every Nth shot. Returns false for shots that should be dropped before any trace.
+	static bool ShouldTraceShot(notnull SCR_SpraySettings settings)
+	{
+		if (!IsStrokeActive(settings))
+			return true;
+
+		return settings.m_Manager.ConsumeStrokeShot();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Shared hit handling for the projectile and raycast paths: orients the normal toward the sprayer,
+	//! rejects characters and over-dense spots, resolves the root entity and paints (or feeds the stroke).
+	//! Returns true when paint was applied.
+	static bool ApplySprayHit(notnull SCR_SpraySettings settings, World world, vector startPos, vector hitPos, vector surfaceNormal, IEntity hitEntity, float lifetime, bool debug)
+	{
+		float decalSize = settings.m_fDecalSize;
+		float minSpacing = settings.m_fMinSpacing;
+		bool strokeMode = IsStrokeActive(settings);
 
 		// Ensure normal faces the sprayer (fixes reversed normals on thin surfaces like glass)
 		vector toSprayer = startPos - hitPos;
@@ -228,36 +455,30 @@ class SCR_SprayProjectile : ScriptComponent
 		// Block painting characters directly
 		if (hitEntity && ChimeraCharacter.Cast(hitEntity))
 		{
-			if (m_bDebug)
+			if (debug)
 				Print("[SprayProjectile] Skipped - hit a character", LogLevel.NORMAL);
 
-			delete owner;
-			return;
+			return false;
 		}
 
-		if (IsTooClose(hitPos, minSpacing, decalSize))
+		// Stroke segments are spaced by construction, so single-shot spacing doesn't apply
+		if (!strokeMode && IsTooClose(hitPos, minSpacing, decalSize))
 		{
-			if (m_bDebug)
+			if (debug)
 				Print("[SprayProjectile] Skipped - too close to existing decal", LogLevel.NORMAL);
 
-			delete owner;
-			return;
+			return false;
 		}
 
 		if (!hitEntity)
-		{
-			world.QueryEntitiesBySphere(hitPos, 1.0, QueryHitEntityCallback);
-			hitEntity = m_QueryResult;
-			m_QueryResult = null;
-		}
+			hitEntity = s_HitQuery.Find(world, hitPos);
 
 		if (!hitEntity)
 		{
-			if (m_bDebug)
+			if (debug)
 				Print("[SprayProjectile] Hit but no entity found to attach decal", LogLevel.WARNING);
 
-			delete owner;
-			return;
+			return false;
 		}
 
 		// Walk up to root parent so decal covers the full object (building + glass, not just a frame piece)
@@ -268,91 +489,119 @@ class SCR_SprayProjectile : ScriptComponent
 			parent = hitEntity.GetParent();
 		}
 
-		ResourceName material = s_sMaterial;
+		ResourceName material = settings.m_sMaterial;
 		if (!material || material.IsEmpty())
 		{
-			if (m_bDebug)
+			if (debug)
 				Print("[SprayProjectile] No decal material set", LogLevel.WARNING);
 
-			delete owner;
-			return;
+			return false;
 		}
 
-		vector decalOrigin = hitPos + surfaceNormal * 0.2;
-
-		Decal decal;
-		if (s_bRandomRotation)
+		if (strokeMode)
 		{
-			float randomAngle = Math.RandomFloat(0, 360);
-			decal = world.CreateDecal(hitEntity, decalOrigin, -surfaceNormal, 0.0, 1.0, randomAngle, decalSize, 1.0, material, m_fDecalLifetime, decalColor);
+			settings.m_Manager.AddStrokePoint(world, hitEntity, hitPos, surfaceNormal, lifetime);
+
+			if (debug)
+				Print(string.Format("[SprayProjectile] Stroke point at %1 on %2", hitPos, hitEntity), LogLevel.NORMAL);
+
+			return true;
 		}
-		else
+
+		int evictedBefore = SCR_SprayDecalBudget.GetInstance().GetEvictedCount();
+		PlaceDecal(settings, world, hitEntity, hitPos, surfaceNormal, decalSize, 1.0, vector.Zero, lifetime);
+
+		// Auto-cycle to next color/stencil if the mode has it enabled
+		if (settings.m_Manager)
+			settings.m_Manager.AutoCycleColor();
+
+		if (debug)
 		{
-			// Build an explicit orientation matrix so the stencil appears
-			// upright on walls and facing the player on floors/ceilings/objects.
+			int evicted = SCR_SprayDecalBudget.GetInstance().GetEvictedCount() - evictedBefore;
+			if (evicted > 0)
+				Print(string.Format("[SprayProjectile] Budget evicted %1 decal(s), live: %2", evicted, SCR_SprayDecalBudget.GetInstance().GetLiveCount()), LogLevel.NORMAL);
 
-			// Desired "up" for the stencil texture:
-			//   - On walls/angled surfaces: project world-up onto the surface plane
-			//   - On near-horizontal surfaces: project player's forward onto the surface plane
-			vector worldUp = Vector(0, 1, 0);
-			float dotNU = vector.Dot(surfaceNormal, worldUp);
-			vector desiredUp = worldUp - surfaceNormal * dotNU;
-			float desLen = desiredUp.Length();
+			Print(string.Format("[SprayProjectile] Decal '%1' at %2 on %3", material, hitPos, hitEntity), LogLevel.NORMAL);
+			Print(string.Format("[SprayProjectile] surfaceNormal=%1  normalY=%2  randomRot=%3",
+				surfaceNormal, surfaceNormal[1], settings.m_bRandomRotation), LogLevel.NORMAL);
+		}
 
-			if (desLen < 0.15)
-			{
-				// Near-horizontal surface — use player forward as stencil "up"
-				float dotNF = vector.Dot(surfaceNormal, s_vPlayerForward);
-				desiredUp = s_vPlayerForward - surfaceNormal * dotNF;
-				desLen = desiredUp.Length();
-			}
+		return true;
+	}
 
-			if (desLen > 0.001)
-				desiredUp = desiredUp * (1.0 / desLen);
-			else
-				desiredUp = Vector(0, 0, 1);
+	//------------------------------------------------------------------------------------------------
+	override protected void OnPostInit(IEntity owner)
+	{
+		super.OnPostInit(owner);
+		SCR_SprayDecalBudget.GetInstance().SetLimits(m_iGlobalDecalCap, m_iPlayerDecalQuota);
+		GetGame().GetCallqueue().CallLater(DoSpray, 0, false, owner);
+	}
 
-			// right = cross(surfaceNormal, desiredUp)  (stencil X-axis)
-			vector right = Vector(
-				surfaceNormal[1] * desiredUp[2] - surfaceNormal[2] * desiredUp[1],
-				surfaceNormal[2] * desiredUp[0] - surfaceNormal[0] * desiredUp[2],
-				surfaceNormal[0] * desiredUp[1] - surfaceNormal[1] * desiredUp[0]
-			);
-			float rLen = right.Length();
-			if (rLen > 0.001)
-				right = right * (1.0 / rLen);
-
-			// Recompute up to ensure orthogonality: up = cross(right, -surfaceNormal)
-			vector up = Vector(
-				right[1] * (-surfaceNormal[2]) - right[2] * (-surfaceNormal[1]),
-				right[2] * (-surfaceNormal[0]) - right[0] * (-surfaceNormal[2]),
-				right[0] * (-surfaceNormal[1]) - right[1] * (-surfaceNormal[0])
-			);
+	//------------------------------------------------------------------------------------------------
+	//! Called from the firing can's muzzle event before DoSpray runs
+	void SetSourceWeapon(IEntity weapon)
+	{
+		m_SourceWeapon = weapon;
+	}
 
-			// Build decal matrix: [right, -up, projectionDir, origin]
-			vector decalMat[4];
-			decalMat[0] = right;
-			decalMat[1] = -up;
-			decalMat[2] = -surfaceNormal;
-			decalMat[3] = decalOrigin;
+	//------------------------------------------------------------------------------------------------
+	protected void DoSpray(IEntity owner)
+	{
+		if (!owner)
+			return;
 
-			decal = world.CreateDecal2(hitEntity, decalMat, 0.0, 1.0, decalSize, 1.0, material, m_fDecalLifetime, decalColor);
+		// The projectile is simulated on every machine. Only the shooter's can tags it with its weapon, so
+		// only the shooter paints, with that can's settings; everyone else gets the decal through the
+		// can's replicated batch.
+		SCR_SpraySettings settings = SCR_SpraySizeManagerComponent.GetWeaponSettings(m_SourceWeapon);
+		if (!settings)
+		{
+			delete owner;
+			return;
 		}
 
-		RemoveSmallerDecals(world, hitPos, decalSize);
-		TrackPosition(hitPos, m_fDecalLifetime, decalSize, decal);
+		// Stroke mode only samples every Nth shot — the rest are dropped before any trace. The engine has
+		// already spawned this projectile by now; only the raycast path avoids that per shot.
+		if (!ShouldTraceShot(settings))
+		{
+			delete owner;
+			return;
+		}
 
-		// Auto-cycle to next color/stencil if the mode has it enabled
-		if (s_Manager)
-			s_Manager.AutoCycleColor();
+		vector mat[4];
+		owner.GetWorldTransform(mat);
+
+		vector startPos = mat[3];
+		vector forward = mat[2];
+		vector rayEnd = startPos + forward * m_fMaxRange;
 
-		if (m_bDebug)
+		World world = owner.GetWorld();
+		if (!world)
 		{
-			Print(string.Format("[SprayProjectile] Decal '%1' at %2 on %3", material, hitPos, hitEntity), LogLevel.NORMAL);
-			Print(string.Format("[SprayProjectile] forward=%1  surfaceNormal=%2  normalY=%3  randomRot=%4",
-				forward, surfaceNormal, surfaceNormal[1], s_bRandomRotation), LogLevel.NORMAL);
+			delete owner;
+			return;
 		}
 
+		TraceParam trace = new TraceParam();
+		trace.Start = startPos;
+		trace.End = rayEnd;
+		trace.Flags = TraceFlags.WORLD | TraceFlags.ENTS;
+		trace.Exclude = owner;
+
+		float hitFraction = world.TraceMove(trace, null);
+
+		if (hitFraction >= 1.0)
+		{
+			if (m_bDebug)
+				Print("[SprayProjectile] Miss - nothing hit", LogLevel.NORMAL);
+
+			delete owner;
+			return;
+		}
+
+		vector hitPos = startPos + (rayEnd - startPos) * hitFraction;
+		ApplySprayHit(settings, world, startPos, hitPos, trace.TraceNorm, trace.TraceEnt, m_fDecalLifetime, m_bDebug);
+
 		delete owner;
 	}
 }
@@ -1,36 +1,53 @@
-[ComponentEditorProps(category: "GameScripted", description: "Raycast spray paint - spawns decal on weapon fire, deletes projectile")]
+[ComponentEditorProps(category: "GameScripted", description: "Raycast spray paint - traces from the aim direction on trigger, no projectile spawned")]
 class SCR_SprayRaycastComponentClass : ScriptComponentClass {}
 
+//! Main spray path of the shipped cans: no projectile is spawned. With m_bHookTrigger the can's magazine
+//! is kept empty so the weapon never fires; this component reads the fire input itself while the local
+//! player holds the can, traces from the CharacterAimingComponent and paints through
+//! SCR_SprayProjectile.ApplySprayHit, so presets, spacing, stencils, strokes and the decal budget behave
+//! exactly like the projectile path. Paint is counted by SCR_SpraySizeManagerComponent.
 class SCR_SprayRaycastComponent : ScriptComponent
 {
-	[Attribute("{9EE38D3540663BCF}Assets/Decals/Blood/Decal_Blood10.emat", UIWidgets.ResourcePickerThumbnail, "Paint decal material (.emat)", "emat")]
-	protected ResourceName m_sDecalMaterial;
+	[Attribute("1", UIWidgets.CheckBox, "Read the fire input directly and keep the magazine empty so no projectile is ever spawned. Disable to fall back to deleting the projectile on muzzle fire.")]
+	protected bool m_bHookTrigger;
 
 	[Attribute("20", UIWidgets.Slider, "Max spray range in meters", "0.5 50 0.5")]
 	protected float m_fMaxRange;
 
-	[Attribute("1.8", UIWidgets.Slider, "Decal size in meters", "0.05 2 0.05")]
-	protected float m_fDecalSize;
+	[Attribute("20", UIWidgets.Slider, "Sprays per second while the trigger is held", "1 60 1")]
+	protected float m_fSpraysPerSecond;
 
 	[Attribute("60", UIWidgets.EditBox, "Decal lifetime in seconds")]
 	protected float m_fDecalLifetime;
 
+	[Attribute("0", UIWidgets.CheckBox, "Enable debug prints")]
+	protected bool m_bDebug;
+
 	protected IEntity m_Owner;
+	protected SCR_SpraySizeManagerComponent m_Manager;
 	protected EventHandlerManagerComponent m_EventHandler;
+	protected ref TraceParam m_Trace = new TraceParam();
+	protected bool m_bFiring;
+	protected bool m_bListening;
 
 	//------------------------------------------------------------------------------------------------
 	override protected void OnPostInit(IEntity owner)
 	{
 		super.OnPostInit(owner);
 		m_Owner = owner;
-		Print("[SprayRaycast] OnPostInit on: " + owner.ToString(), LogLevel.NORMAL);
+		m_Manager = SCR_SpraySizeManagerComponent.Cast(owner.FindComponent(SCR_SpraySizeManagerComponent));
+
+		// The fire input is only listened to while the can is held, see SetHeld
+		if (m_bHookTrigger)
+			return;
 
 		// Hook weapon fire via EventHandlerManagerComponent
 		m_EventHandler = EventHandlerManagerComponent.Cast(owner.FindComponent(EventHandlerManagerComponent));
 		if (m_EventHandler)
 		{
 			m_EventHandler.RegisterScriptHandler("OnMuzzleFired", this, OnMuzzleFired);
-			Print("[SprayRaycast] Registered OnMuzzleFired handler via EventHandlerManagerComponent", LogLevel.NORMAL);
+			if (m_bDebug)
+				Print("[SprayRaycast] Registered OnMuzzleFired handler via EventHandlerManagerComponent", LogLevel.NORMAL);
 		}
 		else
 		{
@@ -39,21 +56,64 @@ class SCR_SprayRaycastComponent : ScriptComponent
 		}
 	}
 
+	//------------------------------------------------------------------------------------------------
+	//! True when this component owns firing; SCR_SpraySizeManagerComponent then hands over the ammo count
+	bool IsTriggerHooked()
+	{
+		return m_bHookTrigger;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	float GetMaxRange()
+	{
+		return m_fMaxRange;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	float GetDecalLifetime()
+	{
+		return m_fDecalLifetime;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Called by SCR_SpraySizeManagerComponent when the local player equips or puts away the can, so
+	//! only the can in hand listens to the fire input
+	void SetHeld(bool held)
+	{
+		if (!m_bHookTrigger || held == m_bListening)
+			return;
+
+		InputManager input = GetGame().GetInputManager();
+		if (!input)
+			return;
+
+		m_bListening = held;
+		if (held)
+		{
+			input.AddActionListener("CharacterFire", EActionTrigger.DOWN, OnFirePressed);
+			input.AddActionListener("CharacterFire", EActionTrigger.UP, OnFireReleased);
+			return;
+		}
+
+		input.RemoveActionListener("CharacterFire", EActionTrigger.DOWN, OnFirePressed);
+		input.RemoveActionListener("CharacterFire", EActionTrigger.UP, OnFireReleased);
+		StopFiring();
+	}
+
 	//------------------------------------------------------------------------------------------------
 	protected void DeferredInit()
 	{
 		if (!m_Owner)
 			return;
 
-		Print("[SprayRaycast] DeferredInit running...", LogLevel.NORMAL);
-
 		SCR_MuzzleEffectComponent muzzleEffect = SCR_MuzzleEffectComponent.Cast(
 			m_Owner.FindComponent(SCR_MuzzleEffectComponent));
 
 		if (muzzleEffect)
 		{
 			muzzleEffect.GetOnWeaponFired().Insert(OnWeaponFiredInvoker);
-			Print("[SprayRaycast] Hooked via SCR_MuzzleEffectComponent invoker", LogLevel.NORMAL);
+			if (m_bDebug)
+				Print("[SprayRaycast] Hooked via SCR_MuzzleEffectComponent invoker", LogLevel.NORMAL);
 		}
 		else
 		{
@@ -61,107 +121,171 @@ class SCR_SprayRaycastComponent : ScriptComponent
 		}
 	}
 
+	//------------------------------------------------------------------------------------------------
+	protected void OnFirePressed(float value = 0.0, EActionTrigger reason = 0)
+	{
+		if (m_bFiring || !IsHeldByLocalPlayer())
+			return;
+
+		if (m_Manager && m_Manager.GetPaint() <= 0)
+		{
+			m_Manager.ShowPaintHint();
+			return;
+		}
+
+		m_bFiring = true;
+		SprayTick();
+		GetGame().GetCallqueue().CallLater(SprayTick, 1000 / Math.Max(m_fSpraysPerSecond, 1), true);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void OnFireReleased(float value = 0.0, EActionTrigger reason = 0)
+	{
+		StopFiring();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void StopFiring()
+	{
+		if (!m_bFiring)
+			return;
+
+		m_bFiring = false;
+		GetGame().GetCallqueue().Remove(SprayTick);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void SprayTick()
+	{
+		if (!m_Manager || !IsHeldByLocalPlayer())
+		{
+			StopFiring();
+			return;
+		}
+
+		// Paint is spent per decal painted, see SCR_SpraySizeManagerComponent.QueueReplicatedDecal
+		if (m_Manager.GetPaint() <= 0)
+		{
+			StopFiring();
+			m_Manager.ShowPaintHint();
+			return;
+		}
+
+		// Stroke mode drops all but every Nth shot before tracing or sending anything
+		if (!SCR_SprayProjectile.ShouldTraceShot(m_Manager.GetSettings()))
+			return;
+
+		vector startPos;
+		vector aimDir;
+		if (!GetAim(startPos, aimDir))
+			return;
+
+		// Paint locally; SCR_SpraySizeManagerComponent batches the resulting decals to everyone else
+		SprayFrom(startPos, aimDir);
+	}
+
 	//------------------------------------------------------------------------------------------------
 	// Called by EventHandlerManagerComponent
 	protected void OnMuzzleFired(int playerID, BaseWeaponComponent weapon, IEntity entity)
 	{
-		Print("[SprayRaycast] >>> OnMuzzleFired event! <<<", LogLevel.NORMAL);
-		DoSprayRaycast();
+		// Fire events run on every machine; only the shooter paints and replicates
+		if (!m_Manager || !IsHeldByLocalPlayer() || !SCR_SprayProjectile.ShouldTraceShot(m_Manager.GetSettings()))
+			return;
+
+		vector startPos;
+		vector aimDir;
+		if (GetAim(startPos, aimDir))
+			SprayFrom(startPos, aimDir);
 	}
 
 	//------------------------------------------------------------------------------------------------
 	// Called by SCR_MuzzleEffectComponent invoker
 	protected void OnWeaponFiredInvoker(IEntity effectEntity, BaseMuzzleComponent muzzle, IEntity projectileEntity)
 	{
-		Print("[SprayRaycast] >>> OnWeaponFiredInvoker! <<<", LogLevel.NORMAL);
-
 		// Delete the projectile so there's no bullet impact
 		if (projectileEntity)
-		{
-			Print("[SprayRaycast] Deleting projectile", LogLevel.NORMAL);
 			delete projectileEntity;
-		}
 
-		DoSprayRaycast();
+		if (!m_Manager || !IsHeldByLocalPlayer() || !SCR_SprayProjectile.ShouldTraceShot(m_Manager.GetSettings()))
+			return;
+
+		vector startPos;
+		vector aimDir;
+		if (GetAim(startPos, aimDir))
+			SprayFrom(startPos, aimDir);
 	}
 
 	//------------------------------------------------------------------------------------------------
-	protected void DoSprayRaycast()
+	protected bool GetAim(out vector startPos, out vector aimDir)
 	{
 		IEntity charEntity = GetCharacterOwner();
 		if (!charEntity)
-		{
-			Print("[SprayRaycast] No character owner!", LogLevel.WARNING);
-			return;
-		}
+			return false;
 
 		CharacterControllerComponent charCtrl = CharacterControllerComponent.Cast(
 			charEntity.FindComponent(CharacterControllerComponent));
 		if (!charCtrl)
-		{
-			Print("[SprayRaycast] No CharacterControllerComponent!", LogLevel.ERROR);
-			return;
-		}
+			return false;
 
 		CharacterAimingComponent aimComp = charCtrl.GetAimingComponent();
 		if (!aimComp)
-		{
-			Print("[SprayRaycast] No AimingComponent!", LogLevel.ERROR);
-			return;
-		}
+			return false;
 
-		vector aimDir = aimComp.GetAimingDirectionWorld();
+		aimDir = aimComp.GetAimingDirectionWorld();
 
 		// Eye position
 		vector charMat[4];
 		charEntity.GetWorldTransform(charMat);
-		vector eyePos = charMat[3] + vector.Up * 1.6;
-		vector rayEnd = eyePos + aimDir * m_fMaxRange;
+		startPos = charMat[3] + vector.Up * 1.6;
+		return true;
+	}
 
-		World world = charEntity.GetWorld();
+	//------------------------------------------------------------------------------------------------
+	protected void SprayFrom(vector startPos, vector aimDir)
+	{
+		World world = m_Owner.GetWorld();
 		if (!world)
 			return;
 
-		TraceParam trace = new TraceParam();
-		trace.Start = eyePos;
-		trace.End = rayEnd;
-		trace.Flags = TraceFlags.WORLD | TraceFlags.ENTS;
-		trace.Exclude = charEntity;
-
-		float hitFraction = world.TraceMove(trace, null);
+		vector rayEnd = startPos + aimDir * m_fMaxRange;
 
-		Print(string.Format("[SprayRaycast] Trace: fraction=%1 hitEnt=%2", hitFraction, trace.TraceEnt), LogLevel.NORMAL);
+		m_Trace.Start = startPos;
+		m_Trace.End = rayEnd;
+		m_Trace.Flags = TraceFlags.WORLD | TraceFlags.ENTS;
+		m_Trace.Exclude = GetCharacterOwner();
+		m_Trace.TraceEnt = null;
 
+		float hitFraction = world.TraceMove(m_Trace, null);
 		if (hitFraction >= 1.0)
 		{
-			Print("[SprayRaycast] Nothing hit", LogLevel.NORMAL);
+			if (m_bDebug)
+				Print("[SprayRaycast] Nothing hit", LogLevel.NORMAL);
+
 			return;
 		}
 
-		vector hitPos = eyePos + (rayEnd - eyePos) * hitFraction;
-		IEntity hitEntity = trace.TraceEnt;
-
-		if (hitEntity)
-		{
-			SpawnDecal(world, hitEntity, hitPos, aimDir);
-		}
-		else
-		{
-			Print("[SprayRaycast] Hit terrain but no entity ref", LogLevel.WARNING);
-		}
+		vector hitPos = startPos + (rayEnd - startPos) * hitFraction;
+		SCR_SprayProjectile.ApplySprayHit(m_Manager.GetSettings(), world, startPos, hitPos, m_Trace.TraceNorm, m_Trace.TraceEnt, m_fDecalLifetime, m_bDebug);
 	}
 
 	//------------------------------------------------------------------------------------------------
-	protected void SpawnDecal(World world, IEntity hitEntity, vector hitPos, vector aimDir)
+	protected bool IsHeldByLocalPlayer()
 	{
-		if (!m_sDecalMaterial || m_sDecalMaterial.IsEmpty())
-		{
-			Print("[SprayRaycast] No decal material!", LogLevel.ERROR);
-			return;
-		}
+		PlayerController pc = GetGame().GetPlayerController();
+		if (!pc)
+			return false;
 
-		world.CreateDecal(hitEntity, hitPos, aimDir, 0.01, 0.5, 0, m_fDecalSize, 1.0, m_sDecalMaterial, m_fDecalLifetime, 0xFFFFFFFF);
-		Print(string.Format("[SprayRaycast] DECAL SPAWNED at %1", hitPos), LogLevel.NORMAL);
+		IEntity player = pc.GetControlledEntity();
+		if (!player)
+			return false;
+
+		BaseWeaponManagerComponent weaponMgr = BaseWeaponManagerComponent.Cast(
+			player.FindComponent(BaseWeaponManagerComponent));
+		if (!weaponMgr)
+			return false;
+
+		BaseWeaponComponent currentWeapon = weaponMgr.GetCurrentWeapon();
+		return currentWeapon && currentWeapon.GetOwner() == m_Owner;
 	}
 
 	//------------------------------------------------------------------------------------------------
@@ -185,6 +309,9 @@ class SCR_SprayRaycastComponent : ScriptComponent
 	override protected void OnDelete(IEntity owner)
 	{
 		GetGame().GetCallqueue().Remove(DeferredInit);
+		GetGame().GetCallqueue().Remove(SprayTick);
+		SetHeld(false);
+
 		super.OnDelete(owner);
 	}
 }
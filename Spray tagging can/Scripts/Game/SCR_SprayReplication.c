@@ -0,0 +1,213 @@
+//------------------------------------------------------------------------------------------------
+//! One painted decal as it travels over the network. Material, size and color are indices into
+//! the spraying can's own presets, so every machine resolves them from the same prefab data.
+class SCR_SprayDecalRecord
+{
+	vector m_vPos;
+	vector m_vNormal;
+	vector m_vStrokeDir;
+	int m_iMaterialIndex;
+	int m_iSizeIndex;
+	int m_iOpacityIndex;
+	int m_iBrightnessIndex;
+	float m_fStretch = 1.0;
+	float m_fAngleDeg;
+	bool m_bRandomRotation;
+
+	// Not encoded per record — a batch shares one lifetime
+	float m_fLifetime;
+}
+
+//------------------------------------------------------------------------------------------------
+//! Packs SCR_SprayDecalRecord into 4 ints (16 bytes) relative to a batch origin:
+//!   word 0: x offset (16) | y offset (16)          — centimetres, +-327 m around the origin
+//!   word 1: z offset (16) | octahedral normal (16)
+//!   word 2: material (10) | size (6) | color (8: opacity index 4, brightness index 4) | stretch (8)
+//!   word 3: octahedral stroke dir (16) | angle (8) | flags (8)
+class SCR_SprayRecordCodec
+{
+	static const int WORDS_PER_RECORD = 4;
+
+	protected static const float POSITION_STEP = 0.01;
+	protected static const int POSITION_LIMIT = 32767;
+	protected static const float STRETCH_STEP = 0.25;
+
+	protected static const int FLAG_RANDOM_ROTATION = 1;
+	protected static const int FLAG_STROKE = 2;
+
+	//------------------------------------------------------------------------------------------------
+	//! False when pos is too far from origin for a 16-bit offset; it then has to start a new batch
+	static bool CanEncode(vector origin, vector pos)
+	{
+		float limit = POSITION_LIMIT * POSITION_STEP;
+		for (int i = 0; i < 3; i++)
+		{
+			if (Math.AbsFloat(pos[i] - origin[i]) > limit)
+				return false;
+		}
+
+		return true;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Appends the record's words to outWords
+	static void Encode(vector origin, notnull SCR_SprayDecalRecord record, notnull array<int> outWords)
+	{
+		int qx = QuantizeOffset(record.m_vPos[0] - origin[0]);
+		int qy = QuantizeOffset(record.m_vPos[1] - origin[1]);
+		int qz = QuantizeOffset(record.m_vPos[2] - origin[2]);
+
+		int color = (Math.ClampInt(record.m_iOpacityIndex, 0, 15) << 4) | Math.ClampInt(record.m_iBrightnessIndex, 0, 15);
+		int stretch = QuantizeStretch(record.m_fStretch);
+		int angle = QuantizeAngle(record.m_fAngleDeg);
+
+		int flags;
+		if (record.m_bRandomRotation)
+			flags |= FLAG_RANDOM_ROTATION;
+
+		int strokeDir;
+		if (record.m_vStrokeDir != vector.Zero)
+		{
+			flags |= FLAG_STROKE;
+			strokeDir = EncodeOctahedral(record.m_vStrokeDir);
+		}
+
+		outWords.Insert((qx << 16) | qy);
+		outWords.Insert((qz << 16) | EncodeOctahedral(record.m_vNormal));
+		outWords.Insert((Math.ClampInt(record.m_iMaterialIndex, 0, 1023) << 22) | (Math.ClampInt(record.m_iSizeIndex, 0, 63) << 16) | (color << 8) | stretch);
+		outWords.Insert((strokeDir << 16) | (angle << 8) | flags);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Unpacks record number index of words into outRecord. False if words is too short.
+	static bool Decode(vector origin, notnull array<int> words, int index, notnull SCR_SprayDecalRecord outRecord)
+	{
+		int base = index * WORDS_PER_RECORD;
+		if (base < 0 || base + WORDS_PER_RECORD > words.Count())
+			return false;
+
+		int w0 = words[base];
+		int w1 = words[base + 1];
+		int w2 = words[base + 2];
+		int w3 = words[base + 3];
+
+		outRecord.m_vPos = Vector(
+			origin[0] + DequantizeOffset((w0 >> 16) & 0xFFFF),
+			origin[1] + DequantizeOffset(w0 & 0xFFFF),
+			origin[2] + DequantizeOffset((w1 >> 16) & 0xFFFF));
+		outRecord.m_vNormal = DecodeOctahedral(w1 & 0xFFFF);
+
+		outRecord.m_iMaterialIndex = (w2 >> 22) & 0x3FF;
+		outRecord.m_iSizeIndex = (w2 >> 16) & 0x3F;
+		outRecord.m_iOpacityIndex = (w2 >> 12) & 0xF;
+		outRecord.m_iBrightnessIndex = (w2 >> 8) & 0xF;
+		outRecord.m_fStretch = DequantizeStretch(w2 & 0xFF);
+
+		int flags = w3 & 0xFF;
+		outRecord.m_fAngleDeg = DequantizeAngle((w3 >> 8) & 0xFF);
+		outRecord.m_bRandomRotation = (flags & FLAG_RANDOM_ROTATION) != 0;
+
+		if (flags & FLAG_STROKE)
+			outRecord.m_vStrokeDir = DecodeOctahedral((w3 >> 16) & 0xFFFF);
+		else
+			outRecord.m_vStrokeDir = vector.Zero;
+
+		return true;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Unit vector -> 8+8 bit octahedral map (y is the fold axis). Worst-case error is about 1 degree.
+	static int EncodeOctahedral(vector n)
+	{
+		float l1 = Math.AbsFloat(n[0]) + Math.AbsFloat(n[1]) + Math.AbsFloat(n[2]);
+		if (l1 < 0.000001)
+			return EncodeOctahedral(vector.Up);
+
+		float u = n[0] / l1;
+		float v = n[2] / l1;
+
+		// Lower hemisphere folds over the diagonals
+		if (n[1] < 0)
+		{
+			float fu = (1.0 - Math.AbsFloat(v)) * SignNotZero(u);
+			float fv = (1.0 - Math.AbsFloat(u)) * SignNotZero(v);
+			u = fu;
+			v = fv;
+		}
+
+		int qu = Math.ClampInt((int)Math.Round((u * 0.5 + 0.5) * 255.0), 0, 255);
+		int qv = Math.ClampInt((int)Math.Round((v * 0.5 + 0.5) * 255.0), 0, 255);
+		return (qu << 8) | qv;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	static vector DecodeOctahedral(int packed)
+	{
+		float u = ((packed >> 8) & 0xFF) / 255.0 * 2.0 - 1.0;
+		float v = (packed & 0xFF) / 255.0 * 2.0 - 1.0;
+		float y = 1.0 - Math.AbsFloat(u) - Math.AbsFloat(v);
+
+		if (y < 0)
+		{
+			float fu = (1.0 - Math.AbsFloat(v)) * SignNotZero(u);
+			float fv = (1.0 - Math.AbsFloat(u)) * SignNotZero(v);
+			u = fu;
+			v = fv;
+		}
+
+		vector n = Vector(u, y, v);
+		return n.Normalized();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Stretch 1..64.75 in quarter steps -> 8 bits
+	static int QuantizeStretch(float stretch)
+	{
+		return Math.ClampInt((int)Math.Round((stretch - 1.0) / STRETCH_STEP), 0, 255);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	static float DequantizeStretch(int bits)
+	{
+		return 1.0 + bits * STRETCH_STEP;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Degrees -> 8 bits (1.4 degree steps)
+	static int QuantizeAngle(float angleDeg)
+	{
+		return (int)Math.Round(angleDeg / 360.0 * 256.0) & 0xFF;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	static float DequantizeAngle(int bits)
+	{
+		return bits / 256.0 * 360.0;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected static int QuantizeOffset(float offset)
+	{
+		int q = Math.ClampInt((int)Math.Round(offset / POSITION_STEP), -POSITION_LIMIT, POSITION_LIMIT);
+		return q & 0xFFFF;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected static float DequantizeOffset(int bits)
+	{
+		// Sign-extend the 16-bit value
+		if (bits >= 32768)
+			bits -= 65536;
+
+		return bits * POSITION_STEP;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected static float SignNotZero(float value)
+	{
+		if (value < 0)
+			return -1.0;
+
+		return 1.0;
+	}
+}
@@ -20,6 +20,9 @@ class SCR_SprayColorEntry
 
 	[Attribute("", UIWidgets.ResourcePickerThumbnail, "Color material (.emat)", "emat")]
 	ResourceName m_sMaterial;
+
+	[Attribute("", UIWidgets.ResourcePickerThumbnail, "Stencil atlas cell material (.emat) written by the Pack Spray Stencils plugin. Used instead of m_sMaterial when the can's stencil atlas is enabled.", "emat")]
+	ResourceName m_sAtlasMaterial;
 }
 
 //------------------------------------------------------------------------------------------------
@@ -61,6 +64,22 @@ class SCR_SprayModePreset
 	ref array<ref SCR_SprayColorEntry> m_aColors;
 }
 
+//------------------------------------------------------------------------------------------------
+//! Resolved settings of one spray can. Each can owns its own and hands it to SCR_SprayProjectile with
+//! every shot, so several players painting at once never overwrite each other's size, color or mode.
+class SCR_SpraySettings
+{
+	float m_fDecalSize = 0.3;
+	float m_fMinSpacing = 0.15;
+	ResourceName m_sMaterial;
+	float m_fOpacity = 1.0;
+	float m_fBrightness = 1.0;
+	bool m_bRandomRotation = true;
+
+	// Owning can: strokes, auto-cycle, holder facing and replication go through it
+	SCR_SpraySizeManagerComponent m_Manager;
+}
+
 //------------------------------------------------------------------------------------------------
 [ComponentEditorProps(category: "GameScripted", description: "Manages spray can size, color and opacity presets — pairs with SCR_SprayProjectile")]
 class SCR_SpraySizeManagerComponentClass : ScriptComponentClass {}
@@ -91,14 +110,99 @@ class SCR_SpraySizeManagerComponent : ScriptComponent
 	[Attribute("0", UIWidgets.CheckBox, "Debug: show stencil orientation arrows on horizontal surfaces")]
 	protected bool m_bDebugOrientation;
 
+	[Attribute("0", UIWidgets.CheckBox, "Stroke mode: trace every Nth shot and merge straight runs into one stretched decal (random-rotation modes only)")]
+	protected bool m_bStrokeMode;
+
+	[Attribute("4", UIWidgets.Slider, "Stroke mode: shots per traced sample", "1 16 1")]
+	protected int m_iStrokeShotsPerSample;
+
+	[Attribute("0.25", UIWidgets.Slider, "Stroke mode: seconds without a new sample before the open segment is painted", "0.05 2 0.05")]
+	protected float m_fStrokeWindow;
+
+	[Attribute("12", UIWidgets.Slider, "Stroke mode: max bend in degrees for samples to merge into one segment", "1 45 1")]
+	protected float m_fStrokeMaxBend;
+
+	[Attribute("2", UIWidgets.Slider, "Stroke mode: max segment length in meters", "0.2 8 0.1")]
+	protected float m_fStrokeMaxLength;
+
+	[Attribute("0.1", UIWidgets.Slider, "Seconds between replicated decal batches from the shooter", "0.05 1 0.05")]
+	protected float m_fReplicationInterval;
+
+	[Attribute("32", UIWidgets.Slider, "Max decals per replicated batch (16 bytes each). Extra decals wait for the next batch.", "4 128 1")]
+	protected int m_iMaxBatchRecords;
+
+	[Attribute("1000", UIWidgets.EditBox, "Server: longest decal lifetime in seconds accepted from a client batch when the can fires projectiles. The raycast path enforces its own lifetime.")]
+	protected float m_fMaxBatchLifetime;
+
+	[Attribute("15", UIWidgets.Slider, "Server: max replicated batches per second from one player, across all their cans. Extra batches are dropped.", "1 60 1")]
+	protected int m_iMaxBatchesPerSecond;
+
+	[Attribute("0", UIWidgets.CheckBox, "Paint stencils from their atlas cell materials so every stencil shares one texture. Entries without an atlas material keep their own.")]
+	protected bool m_bUseStencilAtlas;
+
+	[Attribute("1", UIWidgets.CheckBox, "Periodically merge dense clusters of overlapping free-paint decals into fewer, larger ones")]
+	protected bool m_bCompactDecals;
+
+	[Attribute("5", UIWidgets.Slider, "Compaction: seconds after new paint before a pass starts", "1 60 1")]
+	protected float m_fCompactInterval;
+
+	[Attribute("1", UIWidgets.Slider, "Compaction: milliseconds per frame a pass may use", "1 8 1")]
+	protected int m_iCompactFrameBudgetMs;
+
+	[Attribute("6", UIWidgets.Slider, "Compaction: min overlapping decals in a cluster before it is merged", "2 32 1")]
+	protected int m_iCompactMinCluster;
+
+	[Attribute("2", UIWidgets.Slider, "Compaction: max size in meters of a merged decal", "0.5 8 0.1")]
+	protected float m_fCompactMaxSize;
+
+	[Attribute("0.8", UIWidgets.Slider, "Compaction: how much of the merged footprint the cluster must already cover (overlaps count twice)", "0.3 2 0.05")]
+	protected float m_fCompactMinCoverage;
+
+	// Idle cans only run a cheap held check at this rate; the frame tick runs only while held
+	protected static const int HELD_POLL_MS = 250;
+	protected static const float LASER_MIN_INTERVAL = 1.0 / 30.0;
+	protected static const float LASER_IDLE_INTERVAL = 0.5;
+	protected static const float LASER_MOVE_THRESHOLD_SQ = 0.005 * 0.005;
+	protected static const float LASER_TURN_THRESHOLD_COS = 0.999997; // ~0.15 degrees
+	protected static const float BATCH_REACH_SLACK = 5.0; // metres the holder may move between painting and the server reading the batch
+
+	// Server: batches each player sent in the current one-second window
+	protected static ref map<int, float> s_mBatchWindowStart = new map<int, float>();
+	protected static ref map<int, int> s_mBatchWindowCount = new map<int, int>();
+
+	protected ref SCR_SpraySettings m_Settings = new SCR_SpraySettings();
 	protected ref Shape m_LaserDot;
+	protected ref TraceParam m_LaserTrace = new TraceParam();
+	protected vector m_vLaserStart;
+	protected vector m_vLaserDir;
+	protected vector m_vLaserHit;
+	protected vector m_vLaserNormal;
+	protected bool m_bLaserHit;
+	protected float m_fSinceLaserTrace;
+
+	protected IEntity m_CachedPlayer;
+	protected BaseWeaponManagerComponent m_CachedWeaponManager;
+	protected SCR_SprayRaycastComponent m_Raycast;
+	protected SCR_MuzzleEffectComponent m_MuzzleEffect;
+	protected ref SCR_SprayStrokeBuilder m_StrokeBuilder = new SCR_SprayStrokeBuilder();
+	protected int m_iStrokeShotCounter;
+
+	protected ref array<ref SCR_SprayDecalRecord> m_aPendingRecords = new array<ref SCR_SprayDecalRecord>();
+	protected ref array<int> m_aBatchWords = new array<int>();
+	protected ref SCR_SprayDecalRecord m_DecodeRecord = new SCR_SprayDecalRecord();
+	protected bool m_bReplicationScheduled;
+
+	// Paint left while the raycast path owns firing. The server owns m_iPaint and charges every batch
+	// it relays; the shooter's own count runs ahead of it by whatever is still in flight.
+	[RplProp()]
+	protected int m_iPaint;
+	protected int m_iPaintPredicted = int.MAX;
 
 	protected int m_iSizeIndex = 0;
 	protected int m_iModeIndex = 0;
 	protected int m_iColorIndex = 0;
 	protected int m_iOpacityIndex = 0;
 	protected int m_iBrightnessIndex = 0;
-	protected bool m_bWasActive = false;
 
 	//------------------------------------------------------------------------------------------------
 	protected array<ref SCR_SprayColorEntry> GetCurrentColors()
@@ -117,112 +221,269 @@ class SCR_SpraySizeManagerComponent : ScriptComponent
 		if (m_iAmmoCount > 0)
 			GetGame().GetCallqueue().CallLater(ApplyAmmoCount, 0, false, owner);
 
-		SetEventMask(owner, EntityEvent.FRAME);
-		owner.SetFlags(EntityFlags.ACTIVE, true);
+		// Spacing grid cells are sized to the widest spacing this can uses
+		if (m_aPresets)
+		{
+			float maxSpacing = 0;
+			foreach (SCR_SizePreset preset : m_aPresets)
+			{
+				if (preset.m_fMinSpacing > maxSpacing)
+					maxSpacing = preset.m_fMinSpacing;
+			}
+
+			if (maxSpacing > 0)
+				SCR_SprayProjectile.EnsureGridCellSize(maxSpacing);
+		}
+
+		SCR_SprayDecalCompactor.GetInstance().Configure(m_bCompactDecals, m_fCompactInterval, m_iCompactFrameBudgetMs,
+			m_iCompactMinCluster, m_fCompactMaxSize, m_fCompactMinCoverage);
+
+		m_Settings.m_Manager = this;
+		m_Raycast = SCR_SprayRaycastComponent.Cast(owner.FindComponent(SCR_SprayRaycastComponent));
+		ApplyAllSettings();
+
+		// Only a machine with a local player can hold the can
+		if (!System.IsConsoleApp())
+			GetGame().GetCallqueue().CallLater(PollHeld, HELD_POLL_MS, true);
 	}
 
 	//------------------------------------------------------------------------------------------------
-	override protected void EOnFrame(IEntity owner, float timeSlice)
+	//! Local controlled entity and its weapon manager. The lookup is repeated only when the controlled entity changes.
+	protected BaseWeaponManagerComponent GetLocalWeaponManager(out IEntity player)
 	{
+		player = null;
+
 		PlayerController pc = GetGame().GetPlayerController();
-		if (!pc)
+		if (pc)
+			player = pc.GetControlledEntity();
+
+		if (player != m_CachedPlayer)
+		{
+			m_CachedPlayer = player;
+			m_CachedWeaponManager = null;
+			if (player)
+				m_CachedWeaponManager = BaseWeaponManagerComponent.Cast(player.FindComponent(BaseWeaponManagerComponent));
+		}
+
+		return m_CachedWeaponManager;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! True when the local player's current weapon is this can
+	protected bool IsHeldLocally()
+	{
+		IEntity player;
+		BaseWeaponManagerComponent weaponMgr = GetLocalWeaponManager(player);
+		if (!weaponMgr)
+			return false;
+
+		BaseWeaponComponent currentWeapon = weaponMgr.GetCurrentWeapon();
+		return currentWeapon && currentWeapon.GetOwner() == GetOwner();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void PollHeld()
+	{
+		// Cans lying around or in someone else's inventory stop at the parent check
+		IEntity player;
+		GetLocalWeaponManager(player);
+		if (!player || GetOwner().GetRootParent() != player)
 			return;
 
-		IEntity player = pc.GetControlledEntity();
-		if (!player)
+		if (!IsHeldLocally())
 			return;
 
-		BaseWeaponManagerComponent weaponMgr = BaseWeaponManagerComponent.Cast(
-			player.FindComponent(BaseWeaponManagerComponent));
-		if (!weaponMgr)
+		GetGame().GetCallqueue().Remove(PollHeld);
+		Activate(GetOwner());
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Settings used for every shot from this can
+	SCR_SpraySettings GetSettings()
+	{
+		return m_Settings;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Settings of the can a weapon entity belongs to, null if it isn't a spray can
+	static SCR_SpraySettings GetWeaponSettings(IEntity weapon)
+	{
+		if (!weapon)
+			return null;
+
+		SCR_SpraySizeManagerComponent manager = SCR_SpraySizeManagerComponent.Cast(weapon.FindComponent(SCR_SpraySizeManagerComponent));
+		if (!manager)
+			return null;
+
+		return manager.GetSettings();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Fills m_Settings from the current preset indices
+	protected void ApplyAllSettings()
+	{
+		if (m_aModes && !m_aModes.IsEmpty())
+			m_Settings.m_bRandomRotation = m_aModes[m_iModeIndex].m_bRandomRotation;
+		if (m_aPresets && !m_aPresets.IsEmpty())
+			ApplyCurrentSize();
+		if (GetCurrentColors() && !GetCurrentColors().IsEmpty())
+			ApplyCurrentColor();
+		if (m_aOpacities && !m_aOpacities.IsEmpty())
+			ApplyCurrentOpacity();
+		if (m_aBrightnesses && !m_aBrightnesses.IsEmpty())
+			ApplyCurrentBrightness();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! The can became the current weapon: start ticking and tagging fired projectiles
+	protected void Activate(IEntity owner)
+	{
+		// Force a laser trace on the first frame
+		m_fSinceLaserTrace = LASER_IDLE_INTERVAL;
+
+		if (m_Raycast)
+			m_Raycast.SetHeld(true);
+
+		if (IsPaintTracked())
+			ShowPaintHint();
+
+		// Tag our own projectiles with this can as they leave the muzzle
+		if (!m_MuzzleEffect)
+			m_MuzzleEffect = SCR_MuzzleEffectComponent.Cast(owner.FindComponent(SCR_MuzzleEffectComponent));
+
+		if (m_MuzzleEffect)
+			m_MuzzleEffect.GetOnWeaponFired().Insert(OnWeaponFired);
+
+		SetEventMask(owner, EntityEvent.FRAME);
+		owner.SetFlags(EntityFlags.ACTIVE, true);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void Deactivate(IEntity owner)
+	{
+		m_bLaserHit = false;
+		m_LaserDot = null;
+
+		if (m_Raycast)
+			m_Raycast.SetHeld(false);
+
+		if (m_MuzzleEffect)
+			m_MuzzleEffect.GetOnWeaponFired().Remove(OnWeaponFired);
+
+		ClearEventMask(owner, EntityEvent.FRAME);
+		GetGame().GetCallqueue().CallLater(PollHeld, HELD_POLL_MS, true);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Only hooked while the local player holds the can, so only the shooter's projectiles get a source
+	protected void OnWeaponFired(IEntity effectEntity, BaseMuzzleComponent muzzle, IEntity projectileEntity)
+	{
+		if (!projectileEntity)
 			return;
 
-		BaseWeaponComponent currentWeapon = weaponMgr.GetCurrentWeapon();
+		SCR_SprayProjectile projectile = SCR_SprayProjectile.Cast(projectileEntity.FindComponent(SCR_SprayProjectile));
+		if (projectile)
+			projectile.SetSourceWeapon(GetOwner());
+	}
+
+	//------------------------------------------------------------------------------------------------
+	override protected void EOnFrame(IEntity owner, float timeSlice)
+	{
+		IEntity player;
+		BaseWeaponManagerComponent weaponMgr = GetLocalWeaponManager(player);
+
+		BaseWeaponComponent currentWeapon;
+		if (weaponMgr)
+			currentWeapon = weaponMgr.GetCurrentWeapon();
+
 		if (!currentWeapon || currentWeapon.GetOwner() != owner)
 		{
-			m_bWasActive = false;
+			Deactivate(owner);
 			return;
 		}
 
-		// This can is currently held — register as the active manager
-		SCR_SprayProjectile.SetManager(this);
+		if (!m_bShowLaserDot)
+			return;
 
-		// On first frame of being held, push all instance settings to the projectile statics
-		if (!m_bWasActive)
-		{
-			m_bWasActive = true;
-			bool randomRot = true;
-			if (m_aModes && !m_aModes.IsEmpty())
-				randomRot = m_aModes[m_iModeIndex].m_bRandomRotation;
-			SCR_SprayProjectile.SetRandomRotation(randomRot);
-			if (m_aPresets && !m_aPresets.IsEmpty())
-				ApplyCurrentSize();
-			if (GetCurrentColors() && !GetCurrentColors().IsEmpty())
-				ApplyCurrentColor();
-			if (m_aOpacities && !m_aOpacities.IsEmpty())
-				ApplyCurrentOpacity();
-			if (m_aBrightnesses && !m_aBrightnesses.IsEmpty())
-				ApplyCurrentBrightness();
-		}
+		UpdateLaserDot(owner, timeSlice);
 
-		// Always track player facing for stencil orientation
-		vector charMat[4];
-		player.GetWorldTransform(charMat);
-		float hx = charMat[2][0];
-		float hz = charMat[2][2];
-		float hLen = Math.Sqrt(hx * hx + hz * hz);
-		if (hLen > 0.01)
+		if (m_bDebugOrientation && m_bLaserHit && Math.AbsFloat(m_vLaserNormal[1]) > 0.7)
 		{
-			SCR_SprayProjectile.SetPlayerForward(Vector(hx / hLen, 0, hz / hLen));
-			SCR_SprayProjectile.SetPlayerYaw(Math.Atan2(hx / hLen, -(hz / hLen)) * 57.2958 + 180);
+			vector charMat[4];
+			player.GetWorldTransform(charMat);
+
+			vector forward = GetHolderForward();
+			float yaw = Math.Atan2(forward[0], -forward[2]) * Math.RAD2DEG + 180;
+			float rad = yaw * Math.DEG2RAD;
+
+			// Yellow arrow: stencil "up" direction based on current angle formula
+			// angle=0 is south (0,0,-1), rotates CW around Y
+			vector stencilUp = Vector(Math.Sin(rad), 0, -Math.Cos(rad));
+			Shape.CreateArrow(m_vLaserHit, m_vLaserHit + stencilUp * 0.4, 0.03, ARGB(255, 255, 255, 0), ShapeFlags.ONCE | ShapeFlags.NOZBUFFER);
+
+			// Green arrow: actual player horizontal facing
+			vector playerFacing = Vector(charMat[2][0], 0, charMat[2][2]);
+			Shape.CreateArrow(m_vLaserHit, m_vLaserHit + playerFacing * 0.4, 0.03, ARGB(255, 0, 255, 0), ShapeFlags.ONCE | ShapeFlags.NOZBUFFER);
 		}
+	}
 
-		if (!m_bShowLaserDot)
+	//------------------------------------------------------------------------------------------------
+	//! Re-traces when the muzzle moved or turned past the thresholds (at most 30 Hz), otherwise twice
+	//! a second to catch the world changing under a still aim. The dot shape persists and is only moved.
+	protected void UpdateLaserDot(IEntity owner, float timeSlice)
+	{
+		m_fSinceLaserTrace += timeSlice;
+		if (m_fSinceLaserTrace < LASER_MIN_INTERVAL)
 			return;
 
-		m_LaserDot = null;
-
 		vector mat[4];
 		owner.GetWorldTransform(mat);
 
 		vector start = mat[3];
 		vector dir = mat[2];
-		vector end = start + dir * m_fLaserRange;
+
+		bool moved = vector.DistanceSq(start, m_vLaserStart) > LASER_MOVE_THRESHOLD_SQ || vector.Dot(dir, m_vLaserDir) < LASER_TURN_THRESHOLD_COS;
+		if (!moved && m_fSinceLaserTrace < LASER_IDLE_INTERVAL)
+			return;
 
 		World world = owner.GetWorld();
 		if (!world)
 			return;
 
-		TraceParam trace = new TraceParam();
-		trace.Start = start;
-		trace.End = end;
-		trace.Flags = TraceFlags.WORLD | TraceFlags.ENTS;
-		trace.Exclude = owner;
+		m_fSinceLaserTrace = 0;
+		m_vLaserStart = start;
+		m_vLaserDir = dir;
 
-		float hitFraction = world.TraceMove(trace, null);
-		if (hitFraction >= 1.0)
-			return;
-
-		vector hitPos = start + (end - start) * hitFraction;
+		vector end = start + dir * m_fLaserRange;
 
-		m_LaserDot = Shape.CreateSphere(ARGB(255, 255, 0, 0), ShapeFlags.ONCE | ShapeFlags.NOOUTLINE | ShapeFlags.NOZBUFFER, hitPos, 0.008);
+		m_LaserTrace.Start = start;
+		m_LaserTrace.End = end;
+		m_LaserTrace.Flags = TraceFlags.WORLD | TraceFlags.ENTS;
+		m_LaserTrace.Exclude = owner;
+		m_LaserTrace.TraceEnt = null;
 
-		if (m_bDebugOrientation && Math.AbsFloat(trace.TraceNorm[1]) > 0.7)
+		float hitFraction = world.TraceMove(m_LaserTrace, null);
+		if (hitFraction >= 1.0)
 		{
-			float yaw = SCR_SprayProjectile.GetPlayerYaw();
-			float rad = yaw * Math.DEG2RAD;
+			m_bLaserHit = false;
+			m_LaserDot = null;
+			return;
+		}
 
-			// Yellow arrow: stencil "up" direction based on current angle formula
-			// angle=0 is south (0,0,-1), rotates CW around Y
-			vector stencilUp = Vector(Math.Sin(rad), 0, -Math.Cos(rad));
-			Shape.CreateArrow(hitPos, hitPos + stencilUp * 0.4, 0.03, ARGB(255, 255, 255, 0), ShapeFlags.ONCE | ShapeFlags.NOZBUFFER);
+		m_bLaserHit = true;
+		m_vLaserHit = start + (end - start) * hitFraction;
+		m_vLaserNormal = m_LaserTrace.TraceNorm;
 
-			// Green arrow: actual player horizontal facing
-			vector charMat2[4];
-			player.GetWorldTransform(charMat2);
-			vector playerFacing = Vector(charMat2[2][0], 0, charMat2[2][2]);
-			Shape.CreateArrow(hitPos, hitPos + playerFacing * 0.4, 0.03, ARGB(255, 0, 255, 0), ShapeFlags.ONCE | ShapeFlags.NOZBUFFER);
+		if (!m_LaserDot)
+		{
+			m_LaserDot = Shape.CreateSphere(ARGB(255, 255, 0, 0), ShapeFlags.NOOUTLINE | ShapeFlags.NOZBUFFER, m_vLaserHit, 0.008);
+			return;
 		}
+
+		vector dotMat[4];
+		Math3D.MatrixIdentity4(dotMat);
+		dotMat[3] = m_vLaserHit;
+		m_LaserDot.SetMatrix(dotMat);
 	}
 
 	//------------------------------------------------------------------------------------------------
@@ -237,8 +498,495 @@ class SCR_SpraySizeManagerComponent : ScriptComponent
 			return;
 
 		BaseMagazineComponent mag = muzzle.GetMagazine();
-		if (mag)
-			mag.SetAmmoCount(m_iAmmoCount);
+		if (!mag)
+			return;
+
+		// Raycast path owns firing: the magazine stays empty so no projectile spawns, and the server
+		// counts the paint instead
+		SCR_SprayRaycastComponent raycast = SCR_SprayRaycastComponent.Cast(owner.FindComponent(SCR_SprayRaycastComponent));
+		if (raycast && raycast.IsTriggerHooked())
+		{
+			mag.SetAmmoCount(0);
+			if (Replication.IsServer())
+			{
+				m_iPaint = m_iAmmoCount;
+				Replication.BumpMe();
+			}
+			return;
+		}
+
+		mag.SetAmmoCount(m_iAmmoCount);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! True when the raycast path owns firing, so paint is counted here rather than in the magazine
+	bool IsPaintTracked()
+	{
+		return m_Raycast && m_Raycast.IsTriggerHooked();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Paint left as this machine knows it
+	int GetPaint()
+	{
+		if (Replication.IsServer())
+			return m_iPaint;
+
+		return Math.Min(m_iPaint, m_iPaintPredicted);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! A decal costs one unit of paint; a stroke segment costs one per shot-sized length it covers
+	static int GetPaintCost(float stretch)
+	{
+		return Math.Max(Math.Ceil(stretch), 1);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void SpendPaint(int cost)
+	{
+		if (Replication.IsServer())
+		{
+			m_iPaint = Math.Max(m_iPaint - cost, 0);
+			Replication.BumpMe();
+			return;
+		}
+
+		m_iPaintPredicted = Math.Max(GetPaint() - cost, 0);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! The weapon HUD reads the magazine, which the raycast path keeps empty, so the paint level is
+	//! shown as a hint when the can is drawn or runs dry
+	void ShowPaintHint()
+	{
+		string text = "Out of paint";
+		if (GetPaint() > 0)
+			text = string.Format("Paint left: %1", GetPaint());
+
+		SCR_HintManagerComponent.ShowCustomHint(text, "Spray Can", 2.0);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	bool IsStrokeModeActive()
+	{
+		return m_bStrokeMode;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Called by SCR_SprayProjectile for every shot in stroke mode.
+	//! Returns true for the shots that should be traced (the first of every N).
+	bool ConsumeStrokeShot()
+	{
+		bool sample = m_iStrokeShotCounter == 0;
+		m_iStrokeShotCounter = (m_iStrokeShotCounter + 1) % Math.Max(m_iStrokeShotsPerSample, 1);
+		return sample;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Feeds a traced stroke sample. Paints the previous segment when this point can't extend it.
+	void AddStrokePoint(World world, IEntity hitEntity, vector hitPos, vector surfaceNormal, float lifetime)
+	{
+		// Consecutive samples are N shots apart, so allow a gap of N decal widths
+		float maxGap = m_Settings.m_fDecalSize * Math.Max(m_iStrokeShotsPerSample, 1);
+		float colinearCos = Math.Cos(m_fStrokeMaxBend * Math.DEG2RAD);
+
+		SCR_SprayStrokeSegment closed = m_StrokeBuilder.AddPoint(hitEntity, hitPos, surfaceNormal, lifetime, maxGap, m_fStrokeMaxLength, colinearCos);
+		if (closed)
+			EmitStrokeSegment(world, closed);
+
+		GetGame().GetCallqueue().Remove(FlushStroke);
+		GetGame().GetCallqueue().CallLater(FlushStroke, m_fStrokeWindow * 1000, false);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void FlushStroke()
+	{
+		m_iStrokeShotCounter = 0;
+
+		SCR_SprayStrokeSegment closed = m_StrokeBuilder.Flush();
+		if (closed)
+			EmitStrokeSegment(GetOwner().GetWorld(), closed);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! One decal per segment: centred on the run and stretched to cover it end to end
+	protected void EmitStrokeSegment(World world, SCR_SprayStrokeSegment segment)
+	{
+		if (!world || !segment.m_HitEntity)
+			return;
+
+		float decalSize = m_Settings.m_fDecalSize;
+		vector mid = (segment.m_vStart + segment.m_vEnd) * 0.5;
+		vector dir = segment.GetDirection();
+
+		float stretch = 1.0;
+		if (dir != vector.Zero)
+			stretch = (segment.GetLength() + decalSize) / decalSize;
+
+		SCR_SprayProjectile.PlaceDecal(m_Settings, world, segment.m_HitEntity, mid, segment.m_vNormal, decalSize, stretch, dir, segment.m_fLifetime);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Flat index of a mode/color pair across all modes' color lists
+	int GetPaletteIndex(int modeIndex, int colorIndex)
+	{
+		if (!m_aModes)
+			return -1;
+
+		int index;
+		for (int i = 0; i < modeIndex && i < m_aModes.Count(); i++)
+		{
+			if (m_aModes[i].m_aColors)
+				index += m_aModes[i].m_aColors.Count();
+		}
+
+		return index + colorIndex;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Material behind a GetPaletteIndex value, empty if out of range
+	ResourceName GetPaletteMaterial(int paletteIndex)
+	{
+		if (!m_aModes || paletteIndex < 0)
+			return ResourceName.Empty;
+
+		foreach (SCR_SprayModePreset mode : m_aModes)
+		{
+			if (!mode.m_aColors)
+				continue;
+
+			if (paletteIndex < mode.m_aColors.Count())
+				return ResolveColorMaterial(mode.m_aColors[paletteIndex]);
+
+			paletteIndex -= mode.m_aColors.Count();
+		}
+
+		return ResourceName.Empty;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Called by SCR_SprayProjectile on the shooter's machine for every decal it paints.
+	//! The record is sent with the next batch; presets are captured as indices now, before auto-cycle moves on.
+	void QueueReplicatedDecal(notnull SCR_SprayPositionEntry entry, vector hitPos, vector surfaceNormal, float stretch, vector strokeDir, bool randomRotation, float angleDeg, float lifetime)
+	{
+		if (IsPaintTracked())
+			SpendPaint(GetPaintCost(stretch));
+
+		SCR_SprayGraffitiLayerComponent layer = SCR_SprayGraffitiLayerComponent.GetInstance();
+		if (!Replication.IsRunning() && !layer)
+			return;
+
+		SCR_SprayDecalRecord record = new SCR_SprayDecalRecord();
+		record.m_vPos = hitPos;
+		record.m_vNormal = surfaceNormal;
+		record.m_vStrokeDir = strokeDir;
+		record.m_fStretch = stretch;
+		record.m_bRandomRotation = randomRotation;
+		record.m_fAngleDeg = angleDeg;
+		record.m_fLifetime = lifetime;
+		record.m_iMaterialIndex = GetPaletteIndex(m_iModeIndex, m_iColorIndex);
+		record.m_iSizeIndex = m_iSizeIndex;
+		record.m_iOpacityIndex = m_iOpacityIndex;
+		record.m_iBrightnessIndex = m_iBrightnessIndex;
+
+		// A listen-server host or single player saves its own decals as it paints them
+		if (layer && Replication.IsServer())
+			layer.CaptureDecal(record, m_Settings.m_sMaterial, m_Settings.m_fDecalSize, m_Settings.m_fOpacity, m_Settings.m_fBrightness, lifetime, entry);
+
+		if (!Replication.IsRunning())
+			return;
+
+		m_aPendingRecords.Insert(record);
+
+		if (m_bReplicationScheduled)
+			return;
+
+		m_bReplicationScheduled = true;
+		GetGame().GetCallqueue().CallLater(FlushReplication, m_fReplicationInterval * 1000, false);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Sends one batch: consecutive records that share a lifetime and fit the 16-bit offset range
+	//! around the first one, up to m_iMaxBatchRecords. Anything left goes out on the next tick.
+	protected void FlushReplication()
+	{
+		m_bReplicationScheduled = false;
+		if (m_aPendingRecords.IsEmpty())
+			return;
+
+		SCR_SprayDecalRecord first = m_aPendingRecords[0];
+		vector origin = first.m_vPos;
+		float lifetime = first.m_fLifetime;
+
+		m_aBatchWords.Clear();
+		int taken;
+		int pending = m_aPendingRecords.Count();
+		while (taken < pending && taken < m_iMaxBatchRecords)
+		{
+			SCR_SprayDecalRecord record = m_aPendingRecords[taken];
+			if (record.m_fLifetime != lifetime || !SCR_SprayRecordCodec.CanEncode(origin, record.m_vPos))
+				break;
+
+			SCR_SprayRecordCodec.Encode(origin, record, m_aBatchWords);
+			taken++;
+		}
+
+		if (taken >= pending)
+		{
+			m_aPendingRecords.Clear();
+		}
+		else
+		{
+			array<ref SCR_SprayDecalRecord> remaining = new array<ref SCR_SprayDecalRecord>();
+			for (int i = taken; i < pending; i++)
+			{
+				remaining.Insert(m_aPendingRecords[i]);
+			}
+
+			m_aPendingRecords = remaining;
+			m_bReplicationScheduled = true;
+			GetGame().GetCallqueue().CallLater(FlushReplication, m_fReplicationInterval * 1000, false);
+		}
+
+		// A listen-server host painting its own can fans out directly
+		if (Replication.IsServer())
+			Rpc(RpcDo_SprayBatch, origin, lifetime, m_aBatchWords);
+		else
+			Rpc(RpcAsk_SprayBatch, origin, lifetime, m_aBatchWords);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	[RplRpc(RplChannel.Unreliable, RplRcver.Server)]
+	protected void RpcAsk_SprayBatch(vector origin, float lifetime, array<int> words)
+	{
+		if (!words || words.IsEmpty())
+			return;
+
+		// Drop malformed or oversized batches instead of relaying them
+		int wordsPerRecord = SCR_SprayRecordCodec.WORDS_PER_RECORD;
+		if (words.Count() % wordsPerRecord != 0 || words.Count() > m_iMaxBatchRecords * wordsPerRecord)
+			return;
+
+		// Only the holder can send, and only as fast, as far and as long-lived as the can sprays
+		IEntity holder = GetHolder();
+		if (!holder || !AllowBatch(GetHolderPlayerId()) || !IsBatchInReach(holder.GetOrigin(), origin, words))
+			return;
+
+		lifetime = Math.Clamp(lifetime, 0, GetMaxBatchLifetime());
+
+		if (IsPaintTracked() && !ChargeBatch(origin, words))
+			return;
+
+		// Dedicated servers don't render decals, but track them while the graffiti layer needs their fate
+		SCR_SprayGraffitiLayerComponent layer = SCR_SprayGraffitiLayerComponent.GetInstance();
+		if (!System.IsConsoleApp() || layer)
+			RebuildBatch(origin, lifetime, words, layer);
+
+		Rpc(RpcDo_SprayBatch, origin, lifetime, words);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Server: counts a batch against the player's per-second allowance. False once it is used up.
+	protected bool AllowBatch(int playerId)
+	{
+		float now = GetOwner().GetWorld().GetWorldTime();
+		float windowStart;
+		if (!s_mBatchWindowStart.Find(playerId, windowStart) || now - windowStart >= 1000)
+		{
+			s_mBatchWindowStart.Set(playerId, now);
+			s_mBatchWindowCount.Set(playerId, 1);
+			return true;
+		}
+
+		int sent = s_mBatchWindowCount.Get(playerId);
+		if (sent >= m_iMaxBatchesPerSecond)
+			return false;
+
+		s_mBatchWindowCount.Set(playerId, sent + 1);
+		return true;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Server: true when the batch origin and every record lie within spray range of the holder
+	protected bool IsBatchInReach(vector holderPos, vector origin, array<int> words)
+	{
+		float reach = GetSprayRange() + BATCH_REACH_SLACK;
+		float reachSq = reach * reach;
+		if (vector.DistanceSq(holderPos, origin) > reachSq)
+			return false;
+
+		int count = words.Count() / SCR_SprayRecordCodec.WORDS_PER_RECORD;
+		for (int i = 0; i < count; i++)
+		{
+			if (!SCR_SprayRecordCodec.Decode(origin, words, i, m_DecodeRecord))
+				return false;
+
+			if (vector.DistanceSq(holderPos, m_DecodeRecord.m_vPos) > reachSq)
+				return false;
+		}
+
+		return true;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! How far this can paints. Projectile cans have no range of their own here; the laser dot
+	//! traces as far as they spray.
+	protected float GetSprayRange()
+	{
+		if (m_Raycast)
+			return m_Raycast.GetMaxRange();
+
+		return m_fLaserRange;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected float GetMaxBatchLifetime()
+	{
+		if (IsPaintTracked())
+			return m_Raycast.GetDecalLifetime();
+
+		return m_fMaxBatchLifetime;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Takes the paint for a client's batch. Records the can can't pay for are cut off the end;
+	//! false if not even the first one is covered.
+	protected bool ChargeBatch(vector origin, array<int> words)
+	{
+		int count = words.Count() / SCR_SprayRecordCodec.WORDS_PER_RECORD;
+		int paid;
+		int cost;
+		while (paid < count)
+		{
+			if (!SCR_SprayRecordCodec.Decode(origin, words, paid, m_DecodeRecord))
+				break;
+
+			int recordCost = GetPaintCost(m_DecodeRecord.m_fStretch);
+			if (cost + recordCost > m_iPaint)
+				break;
+
+			cost += recordCost;
+			paid++;
+		}
+
+		if (paid == 0)
+			return false;
+
+		if (paid < count)
+			words.Resize(paid * SCR_SprayRecordCodec.WORDS_PER_RECORD);
+
+		SpendPaint(cost);
+		return true;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	[RplRpc(RplChannel.Unreliable, RplRcver.Broadcast)]
+	protected void RpcDo_SprayBatch(vector origin, float lifetime, array<int> words)
+	{
+		// The shooter painted these when they were sprayed
+		if (!words || IsHeldLocally())
+			return;
+
+		RebuildBatch(origin, lifetime, words);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Recreates a received batch. On the server, layer saves each rebuilt decal.
+	protected void RebuildBatch(vector origin, float lifetime, array<int> words, SCR_SprayGraffitiLayerComponent layer = null)
+	{
+		World world = GetOwner().GetWorld();
+		if (!world)
+			return;
+
+		int playerId = GetHolderPlayerId();
+		int count = words.Count() / SCR_SprayRecordCodec.WORDS_PER_RECORD;
+		for (int i = 0; i < count; i++)
+		{
+			if (!SCR_SprayRecordCodec.Decode(origin, words, i, m_DecodeRecord))
+				break;
+
+			ResourceName material;
+			float decalSize;
+			float opacity;
+			float brightness;
+			if (!ResolveRecord(m_DecodeRecord, material, decalSize, opacity, brightness))
+				continue;
+
+			SCR_SprayPositionEntry entry = SCR_SprayProjectile.RebuildDecal(world, m_DecodeRecord, material, decalSize, opacity, brightness, lifetime, playerId);
+			if (entry && layer)
+				layer.CaptureDecal(m_DecodeRecord, material, decalSize, opacity, brightness, lifetime, entry);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Looks up the preset indices of a decoded record in this can's lists. False if any is out of range.
+	bool ResolveRecord(SCR_SprayDecalRecord record, out ResourceName material, out float decalSize, out float opacity, out float brightness)
+	{
+		material = GetPaletteMaterial(record.m_iMaterialIndex);
+		if (material.IsEmpty())
+			return false;
+
+		if (!m_aPresets || record.m_iSizeIndex >= m_aPresets.Count())
+			return false;
+
+		decalSize = m_aPresets[record.m_iSizeIndex].m_fDecalSize;
+
+		opacity = 1.0;
+		if (m_aOpacities && record.m_iOpacityIndex < m_aOpacities.Count())
+			opacity = m_aOpacities[record.m_iOpacityIndex].m_fAlpha;
+
+		brightness = 1.0;
+		if (m_aBrightnesses && record.m_iBrightnessIndex < m_aBrightnesses.Count())
+			brightness = m_aBrightnesses[record.m_iBrightnessIndex].m_fBrightness;
+
+		return true;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Character holding this can, null if it isn't held
+	IEntity GetHolder()
+	{
+		IEntity parent = GetOwner().GetParent();
+		while (parent)
+		{
+			if (ChimeraCharacter.Cast(parent))
+				return parent;
+
+			parent = parent.GetParent();
+		}
+
+		return null;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Player ID of the character holding this can, 0 if none (used for per-player decal quotas)
+	int GetHolderPlayerId()
+	{
+		IEntity holder = GetHolder();
+		if (!holder)
+			return 0;
+
+		return GetGame().GetPlayerManager().GetPlayerIdFromControlledEntity(holder);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Horizontal facing of the holder, read when a stencil is placed. Falls back to +Z.
+	vector GetHolderForward()
+	{
+		IEntity holder = GetHolder();
+		if (!holder)
+			return vector.Forward;
+
+		vector charMat[4];
+		holder.GetWorldTransform(charMat);
+		float hx = charMat[2][0];
+		float hz = charMat[2][2];
+		float hLen = Math.Sqrt(hx * hx + hz * hz);
+		if (hLen <= 0.01)
+			return vector.Forward;
+
+		return Vector(hx / hLen, 0, hz / hLen);
 	}
 
 	//------------------------------------------------------------------------------------------------
@@ -260,7 +1008,7 @@ class SCR_SpraySizeManagerComponent : ScriptComponent
 		m_iModeIndex = (m_iModeIndex + 1) % m_aModes.Count();
 
 		SCR_SprayModePreset mode = m_aModes[m_iModeIndex];
-		SCR_SprayProjectile.SetRandomRotation(mode.m_bRandomRotation);
+		m_Settings.m_bRandomRotation = mode.m_bRandomRotation;
 
 		array<ref SCR_SprayColorEntry> colors = mode.m_aColors;
 		if (colors && !colors.IsEmpty())
@@ -297,7 +1045,8 @@ class SCR_SpraySizeManagerComponent : ScriptComponent
 	protected void ApplyCurrentSize()
 	{
 		SCR_SizePreset preset = m_aPresets[m_iSizeIndex];
-		SCR_SprayProjectile.SetSize(preset.m_fDecalSize, preset.m_fMinSpacing);
+		m_Settings.m_fDecalSize = preset.m_fDecalSize;
+		m_Settings.m_fMinSpacing = preset.m_fMinSpacing;
 	}
 
 	//------------------------------------------------------------------------------------------------
@@ -307,8 +1056,17 @@ class SCR_SpraySizeManagerComponent : ScriptComponent
 		if (!colors || colors.IsEmpty())
 			return;
 
-		SCR_SprayColorEntry entry = colors[m_iColorIndex];
-		SCR_SprayProjectile.SetMaterial(entry.m_sMaterial);
+		m_Settings.m_sMaterial = ResolveColorMaterial(colors[m_iColorIndex]);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Atlas cell material when the stencil atlas is enabled and the entry has one, otherwise its own
+	protected ResourceName ResolveColorMaterial(notnull SCR_SprayColorEntry entry)
+	{
+		if (m_bUseStencilAtlas && !entry.m_sAtlasMaterial.IsEmpty())
+			return entry.m_sAtlasMaterial;
+
+		return entry.m_sMaterial;
 	}
 
 	//------------------------------------------------------------------------------------------------
@@ -324,13 +1082,13 @@ class SCR_SpraySizeManagerComponent : ScriptComponent
 	//------------------------------------------------------------------------------------------------
 	protected void ApplyCurrentOpacity()
 	{
-		SCR_SprayProjectile.SetOpacity(m_aOpacities[m_iOpacityIndex].m_fAlpha);
+		m_Settings.m_fOpacity = m_aOpacities[m_iOpacityIndex].m_fAlpha;
 	}
 
 	//------------------------------------------------------------------------------------------------
 	protected void ApplyCurrentBrightness()
 	{
-		SCR_SprayProjectile.SetBrightness(m_aBrightnesses[m_iBrightnessIndex].m_fBrightness);
+		m_Settings.m_fBrightness = m_aBrightnesses[m_iBrightnessIndex].m_fBrightness;
 	}
 
 	//------------------------------------------------------------------------------------------------
@@ -353,6 +1111,19 @@ class SCR_SpraySizeManagerComponent : ScriptComponent
 		ApplyCurrentColor();
 	}
 
+	//------------------------------------------------------------------------------------------------
+	override protected void OnDelete(IEntity owner)
+	{
+		GetGame().GetCallqueue().Remove(FlushStroke);
+		GetGame().GetCallqueue().Remove(FlushReplication);
+		GetGame().GetCallqueue().Remove(PollHeld);
+
+		if (m_MuzzleEffect)
+			m_MuzzleEffect.GetOnWeaponFired().Remove(OnWeaponFired);
+
+		super.OnDelete(owner);
+	}
+
 	//------------------------------------------------------------------------------------------------
 	bool HasModes()
 	{
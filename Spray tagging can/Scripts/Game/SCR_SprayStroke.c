@@ -0,0 +1,101 @@
+//------------------------------------------------------------------------------------------------
+//! One straight run of stroke hit points on a single surface
+class SCR_SprayStrokeSegment
+{
+	IEntity m_HitEntity;
+	vector m_vStart;
+	vector m_vEnd;
+	vector m_vNormal;
+	float m_fLifetime;
+	int m_iPoints;
+
+	//------------------------------------------------------------------------------------------------
+	float GetLength()
+	{
+		return vector.Distance(m_vStart, m_vEnd);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Unit direction along the surface, vector.Zero for a single-point segment
+	vector GetDirection()
+	{
+		vector dir = m_vEnd - m_vStart;
+		if (dir.LengthSq() < 0.000001)
+			return vector.Zero;
+
+		return dir.Normalized();
+	}
+}
+
+//------------------------------------------------------------------------------------------------
+//! Accumulates sampled stroke hit points and merges colinear ones into segments.
+//! A segment is closed when the next point bends, jumps, changes surface or exceeds the max length.
+class SCR_SprayStrokeBuilder
+{
+	protected ref SCR_SprayStrokeSegment m_Current;
+
+	//------------------------------------------------------------------------------------------------
+	bool HasPending()
+	{
+		return m_Current != null;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Adds a hit point. Returns the segment it closed, or null if the point extended the open one.
+	SCR_SprayStrokeSegment AddPoint(IEntity hitEntity, vector pos, vector normal, float lifetime, float maxGap, float maxLength, float colinearCos)
+	{
+		if (m_Current && CanExtend(hitEntity, pos, normal, maxGap, maxLength, colinearCos))
+		{
+			m_Current.m_vEnd = pos;
+			m_Current.m_iPoints++;
+			return null;
+		}
+
+		SCR_SprayStrokeSegment closed = m_Current;
+
+		m_Current = new SCR_SprayStrokeSegment();
+		m_Current.m_HitEntity = hitEntity;
+		m_Current.m_vStart = pos;
+		m_Current.m_vEnd = pos;
+		m_Current.m_vNormal = normal;
+		m_Current.m_fLifetime = lifetime;
+		m_Current.m_iPoints = 1;
+
+		return closed;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Closes and returns the open segment, if any
+	SCR_SprayStrokeSegment Flush()
+	{
+		SCR_SprayStrokeSegment closed = m_Current;
+		m_Current = null;
+		return closed;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected bool CanExtend(IEntity hitEntity, vector pos, vector normal, float maxGap, float maxLength, float colinearCos)
+	{
+		if (hitEntity != m_Current.m_HitEntity)
+			return false;
+
+		// Bent surface (corner, step) — start a new segment so the decal doesn't float
+		if (vector.Dot(normal, m_Current.m_vNormal) < 0.9)
+			return false;
+
+		vector step = pos - m_Current.m_vEnd;
+		float stepLen = step.Length();
+		if (stepLen > maxGap)
+			return false;
+
+		if (vector.Distance(m_Current.m_vStart, pos) > maxLength)
+			return false;
+
+		// Second point defines the direction
+		vector dir = m_Current.GetDirection();
+		if (dir == vector.Zero || stepLen < 0.001)
+			return true;
+
+		return vector.Dot(step * (1.0 / stepLen), dir) >= colinearCos;
+	}
+}
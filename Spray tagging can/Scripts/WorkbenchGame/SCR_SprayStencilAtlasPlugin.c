@@ -0,0 +1,268 @@
+/**
+ * SCR_SprayStencilAtlasPlugin.c
+ * Packs the spray stencil textures into one atlas so stencil decals share a single texture.
+ *
+ * Usage:
+ *   1. Plugins > Pack Spray Stencils (Resource Manager).
+ *   2. Check the source folder and tool path, then click Pack.
+ *   3. Assign each generated Atlas/<stencil>.emat to the matching SCR_SprayColorEntry's
+ *      m_sAtlasMaterial and enable m_bUseStencilAtlas on the can.
+ *
+ * Every .emat in the source folder with a BCRMap is a stencil. Its source image (the .png next to
+ * the .edds) goes into one grid cell of StencilAtlas.png, composed with ImageMagick. Decals only take
+ * a material, so what is shared is the texture, not the material: each cell still gets its own small
+ * material that points at the atlas and selects its sub-rectangle through the shader's UV transform.
+ * Decals using different cells therefore still switch material and don't batch; the gain is one
+ * texture to stream and keep resident instead of one per stencil.
+ *
+ * The UV parameter names are settings because they depend on the decal shader. Before writing anything
+ * the plugin checks them against the variables of a source stencil material and stops if either is
+ * missing, listing the UV-related variables the material does have.
+ */
+
+[WorkbenchPluginAttribute(
+	name: "Pack Spray Stencils",
+	description: "Packs spray stencil textures into one shared atlas texture and writes a material per atlas cell.",
+	wbModules: {"ResourceManager"},
+	awesomeFontCode: 0xF00A
+)]
+class SCR_SprayStencilAtlasPlugin : ResourceManagerPlugin
+{
+	[Attribute(defvalue: "$SprayTaggingCan:", desc: "File system of the spray addon")]
+	string m_sAddonFileSystem;
+
+	[Attribute(defvalue: "Assets/Decal opaticy maps", desc: "Addon-relative folder with the stencil .emat files")]
+	string m_sSourceFolder;
+
+	[Attribute(defvalue: "Assets/Decal opaticy maps/Atlas", desc: "Addon-relative folder for the atlas image and cell materials")]
+	string m_sOutputFolder;
+
+	[Attribute(defvalue: "512", desc: "Pixel size of one atlas cell")]
+	int m_iCellSize;
+
+	[Attribute(defvalue: "magick", desc: "ImageMagick executable used to compose the atlas")]
+	string m_sImageTool;
+
+	[Attribute(defvalue: "UVScale", desc: "Name of the decal shader's UV scale parameter")]
+	string m_sUVScaleParam;
+
+	[Attribute(defvalue: "UVOffset", desc: "Name of the decal shader's UV offset parameter")]
+	string m_sUVOffsetParam;
+
+	protected ref array<ResourceName> m_aFoundMaterials = {};
+
+	//------------------------------------------------------------------------------------------------
+	override void Run()
+	{
+		Workbench.ScriptDialog("Pack Spray Stencils", "Packs every stencil material in the source folder into one atlas.\nCheck the folders and the ImageMagick path, then click 'Pack'.", this);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	[ButtonAttribute("Pack")]
+	void Pack()
+	{
+		string addonRoot;
+		if (!Workbench.GetAbsolutePath(m_sAddonFileSystem, addonRoot, false))
+		{
+			Print("[SprayStencilAtlas] ERROR: Could not resolve " + m_sAddonFileSystem + ". Make sure the addon is loaded.", LogLevel.ERROR);
+			return;
+		}
+
+		addonRoot.Replace("\\", "/");
+		while (addonRoot.EndsWith("/"))
+			addonRoot = addonRoot.Substring(0, addonRoot.Length() - 1);
+
+		// Collect stencils: materials with a BCRMap whose source image is on disk
+		m_aFoundMaterials.Clear();
+		Workbench.SearchResources(OnMaterialFound, {"emat"}, null, m_sSourceFolder, false);
+		m_aFoundMaterials.Sort();
+
+		array<string> stencilNames = {};
+		array<string> sourceImages = {};
+		foreach (ResourceName material : m_aFoundMaterials)
+		{
+			string image = GetSourceImage(material, addonRoot);
+			if (image.IsEmpty())
+				continue;
+
+			stencilNames.Insert(FilePath.StripExtension(FilePath.StripPath(material.GetPath())));
+			sourceImages.Insert(image);
+		}
+
+		int count = stencilNames.Count();
+		if (count == 0)
+		{
+			Print("[SprayStencilAtlas] No stencils found in " + m_sSourceFolder, LogLevel.WARNING);
+			return;
+		}
+
+		// Cell materials are only useful if the shader reads the UV parameters they set
+		if (!CheckUVParams(m_aFoundMaterials[0]))
+			return;
+
+		int columns = Math.Ceil(Math.Sqrt(count));
+		int rows = Math.Ceil(count / (float)columns);
+
+		string absOutputFolder = addonRoot + "/" + m_sOutputFolder;
+		if (!FileIO.FileExists(absOutputFolder) && !FileIO.MakeDirectory(absOutputFolder))
+		{
+			Print("[SprayStencilAtlas] ERROR: Failed to create folder: " + absOutputFolder, LogLevel.ERROR);
+			return;
+		}
+
+		string atlasImage = absOutputFolder + "/StencilAtlas.png";
+		if (!ComposeAtlas(sourceImages, columns, rows, atlasImage))
+			return;
+
+		ResourceManager resourceManager = Workbench.GetModule(ResourceManager);
+		resourceManager.RegisterResourceFile(atlasImage);
+
+		string atlasTexture = GetResourceId(resourceManager, absOutputFolder + "/StencilAtlas.edds");
+		if (atlasTexture.IsEmpty())
+			atlasTexture = m_sOutputFolder + "/StencilAtlas.edds";
+
+		Print(string.Format("[SprayStencilAtlas] Packed %1 stencils into a %2x%3 atlas (%4x%5 px)", count, columns, rows, columns * m_iCellSize, rows * m_iCellSize), LogLevel.NORMAL);
+
+		for (int i = 0; i < count; i++)
+		{
+			int column = i % columns;
+			int row = i / columns;
+
+			string cellMaterial = absOutputFolder + "/" + stencilNames[i] + ".emat";
+			if (!WriteCellMaterial(cellMaterial, atlasTexture, 1.0 / columns, 1.0 / rows, column / (float)columns, row / (float)rows))
+				continue;
+
+			resourceManager.RegisterResourceFile(cellMaterial);
+			Print(string.Format("[SprayStencilAtlas] %1 -> %2/%1.emat (cell %3,%4)", stencilNames[i], m_sOutputFolder, column, row), LogLevel.NORMAL);
+		}
+
+		Print("[SprayStencilAtlas] Done. Assign the cell materials to m_sAtlasMaterial on the matching color entries.", LogLevel.NORMAL);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void OnMaterialFound(ResourceName resName, string filePath = "")
+	{
+		m_aFoundMaterials.Insert(resName);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Absolute path of the .png the material's BCRMap was imported from, empty if it isn't a stencil
+	protected string GetSourceImage(ResourceName material, string addonRoot)
+	{
+		Resource resource = BaseContainerTools.LoadContainer(material);
+		if (!resource || !resource.IsValid())
+			return string.Empty;
+
+		BaseContainer container = resource.GetResource().ToBaseContainer();
+		ResourceName texture;
+		container.Get("BCRMap", texture);
+		if (texture.IsEmpty())
+			return string.Empty;
+
+		string image = addonRoot + "/" + FilePath.ReplaceExtension(texture.GetPath(), "png");
+		if (!FileIO.FileExists(image))
+		{
+			Print("[SprayStencilAtlas] WARNING: No source image " + image + " for " + material.GetPath() + ", skipping.", LogLevel.WARNING);
+			return string.Empty;
+		}
+
+		return image;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! True when a stencil material of the same shader has both UV parameters. Otherwise prints the
+	//! material's UV-related variables to pick the right names from.
+	protected bool CheckUVParams(ResourceName material)
+	{
+		Resource resource = BaseContainerTools.LoadContainer(material);
+		if (!resource || !resource.IsValid())
+			return false;
+
+		BaseContainer container = resource.GetResource().ToBaseContainer();
+		if (container.GetVarIndex(m_sUVScaleParam) != -1 && container.GetVarIndex(m_sUVOffsetParam) != -1)
+			return true;
+
+		string candidates;
+		int varCount = container.GetNumVars();
+		for (int i = 0; i < varCount; i++)
+		{
+			string varName = container.GetVarName(i);
+			string lowerName = varName;
+			lowerName.ToLower();
+			if (lowerName.Contains("uv") || lowerName.Contains("tiling") || lowerName.Contains("offset"))
+				candidates += " " + varName;
+		}
+
+		Print(string.Format("[SprayStencilAtlas] ERROR: %1 (%2) has no '%3' or '%4' parameter. Set the UV parameter names in the plugin settings. UV-related parameters:%5",
+			material.GetPath(), container.GetClassName(), m_sUVScaleParam, m_sUVOffsetParam, candidates), LogLevel.ERROR);
+		return false;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected bool ComposeAtlas(array<string> sourceImages, int columns, int rows, string atlasImage)
+	{
+		string inputs;
+		foreach (string image : sourceImages)
+		{
+			inputs += "\"" + image + "\" ";
+		}
+
+		// Each image is fitted into its cell; transparent padding keeps the stencil alpha intact
+		string command = string.Format("\"%1\" montage %2-tile %3x%4 -geometry %5x%5+0+0 -background none \"%6\"",
+			m_sImageTool, inputs, columns, rows, m_iCellSize, atlasImage);
+
+		int exitCode = Workbench.RunCmd(command, true);
+		if (exitCode != 0 || !FileIO.FileExists(atlasImage))
+		{
+			Print("[SprayStencilAtlas] ERROR: Composing the atlas failed (" + exitCode + "): " + command, LogLevel.ERROR);
+			return false;
+		}
+
+		return true;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected string GetResourceId(ResourceManager resourceManager, string absPath)
+	{
+		MetaFile meta = resourceManager.GetMetaFile(absPath);
+		if (!meta)
+			return string.Empty;
+
+		return meta.GetResourceID();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Same shading as the hand-made stencil materials, sampling one cell of the shared atlas
+	protected bool WriteCellMaterial(string absPath, string atlasTexture, float scaleU, float scaleV, float offsetU, float offsetV)
+	{
+		FileHandle file = FileIO.OpenFile(absPath, FileMode.WRITE);
+		if (!file)
+		{
+			Print("[SprayStencilAtlas] ERROR: Cannot write " + absPath, LogLevel.ERROR);
+			return false;
+		}
+
+		file.WriteLine("MatPBRDecal {");
+		file.WriteLine(" Color 1 1 1 1");
+		file.WriteLine(" DiffuseIBL 1 1 1 1");
+		file.WriteLine(" AlphaTest 0.1");
+		file.WriteLine(" AlphaMul 4");
+		file.WriteLine(" MetalnessScale 0");
+		file.WriteLine(" DielectricReflectance 0.02");
+		file.WriteLine(" BCRMap \"" + atlasTexture + "\"");
+		file.WriteLine(string.Format(" %1 %2 %3", m_sUVScaleParam, scaleU, scaleV));
+		file.WriteLine(string.Format(" %1 %2 %3", m_sUVOffsetParam, offsetU, offsetV));
+		file.WriteLine(" DecalCategory Static");
+		file.WriteLine(" GBufferNormal 0");
+		file.WriteLine(" GBufferAO 0");
+		file.WriteLine("}");
+		file.Close();
+		return true;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	override void Configure()
+	{
+		Workbench.ScriptDialog("Pack Spray Stencils — Settings", "Source and output folders are addon-relative.", this);
+	}
+}